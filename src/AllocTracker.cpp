@@ -0,0 +1,152 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+//  Everything here is fixed size and static: the counters are updated from
+//  inside operator new, so they must never allocate themselves.
+//
+struct TagCounters {
+	std::atomic<uint64_t> allocs;
+	std::atomic<uint64_t> bytes;
+	std::atomic<uint64_t> frees;
+};
+
+static TagCounters counters[allocMaxTags];
+static const char *tagNames[allocMaxTags] = { "other" };
+static std::atomic<int> tagCount(1);
+static std::atomic<int64_t> liveBytes(0);
+static std::atomic<int64_t> peakBytes(0);
+static thread_local int currentTag = 0;
+
+bool allocTrackingEnabled() {
+#ifdef LANDER_TRACK_ALLOCS
+	return true;
+#else
+	return false;
+#endif
+}
+
+//  Tags are registered once per call site (ALLOC_TAG keeps the id in a
+//  static), so a mutex here costs nothing per allocation.  Registering the
+//  same name twice returns the same tag.
+//
+int allocTag(const char *name) {
+	static std::mutex lock;
+	std::lock_guard<std::mutex> guard(lock);
+	int n = tagCount.load();
+	for (int i = 0; i < n; i++) {
+		if (strcmp(tagNames[i], name) == 0) return i;
+	}
+	if (n == allocMaxTags) return 0;
+	tagNames[n] = name;
+	tagCount.store(n + 1);
+	return n;
+}
+
+const char *allocTagName(int tag) {
+	return tag >= 0 && tag < tagCount.load() ? tagNames[tag] : "";
+}
+
+void allocSnapshot(AllocSnapshot & s) {
+	s.tags = tagCount.load();
+	for (int i = 0; i < allocMaxTags; i++) {
+		s.allocs[i] = counters[i].allocs.load(std::memory_order_relaxed);
+		s.bytes[i] = counters[i].bytes.load(std::memory_order_relaxed);
+		s.frees[i] = counters[i].frees.load(std::memory_order_relaxed);
+	}
+	s.live = liveBytes.load(std::memory_order_relaxed);
+	s.peak = peakBytes.load(std::memory_order_relaxed);
+}
+
+void allocResetPeak() {
+	peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+//  Counts are the change from before to after; live and peak are as of
+//  after
+//
+AllocSnapshot allocDelta(const AllocSnapshot & before, const AllocSnapshot & after) {
+	AllocSnapshot d = after;
+	for (int i = 0; i < allocMaxTags; i++) {
+		d.allocs[i] -= before.allocs[i];
+		d.bytes[i] -= before.bytes[i];
+		d.frees[i] -= before.frees[i];
+	}
+	return d;
+}
+
+uint64_t allocTotal(const AllocSnapshot & s) {
+	uint64_t n = 0;
+	for (int i = 0; i < s.tags; i++) n += s.allocs[i];
+	return n;
+}
+
+AllocTagScope::AllocTagScope(int tag) {
+	previous = currentTag;
+	currentTag = tag;
+}
+
+AllocTagScope::~AllocTagScope() {
+	currentTag = previous;
+}
+
+#ifdef LANDER_TRACK_ALLOCS
+
+//  Each block is preceded by a header recording its size and tag, so the
+//  free can be charged to the tag that allocated it.  The header is 16
+//  bytes to keep the block aligned for any fundamental type.
+//
+struct AllocHeader {
+	uint64_t size;
+	uint32_t tag;
+	uint32_t pad;
+};
+
+static void *trackedAlloc(size_t size) {
+	AllocHeader *h = (AllocHeader *)malloc(sizeof(AllocHeader) + size);
+	if (!h) return NULL;
+	h->size = size;
+	h->tag = currentTag;
+
+	TagCounters & c = counters[h->tag];
+	c.allocs.fetch_add(1, std::memory_order_relaxed);
+	c.bytes.fetch_add(size, std::memory_order_relaxed);
+	int64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	int64_t peak = peakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+	return h + 1;
+}
+
+static void trackedFree(void *p) {
+	if (!p) return;
+	AllocHeader *h = (AllocHeader *)p - 1;
+	counters[h->tag].frees.fetch_add(1, std::memory_order_relaxed);
+	liveBytes.fetch_sub(h->size, std::memory_order_relaxed);
+	free(h);
+}
+
+void *operator new(size_t size) {
+	void *p = trackedAlloc(size);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t size) {
+	void *p = trackedAlloc(size);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return trackedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return trackedAlloc(size); }
+void operator delete(void *p) noexcept { trackedFree(p); }
+void operator delete[](void *p) noexcept { trackedFree(p); }
+void operator delete(void *p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void *p, size_t) noexcept { trackedFree(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { trackedFree(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { trackedFree(p); }
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+//  Opt-in heap allocation tracking.
+//
+//  Build with LANDER_TRACK_ALLOCS defined to replace the global operator
+//  new/delete with versions that count allocations, frees and bytes, in
+//  total and per tag.  ALLOC_TAG("name") tags the allocations made by the
+//  calling thread for the rest of the enclosing block, so they can be
+//  charged to a subsystem.  Untagged allocations go to tag 0, "other".
+//
+//  Without LANDER_TRACK_ALLOCS nothing is replaced, ALLOC_TAG compiles to
+//  nothing and every count stays at zero (allocTrackingEnabled() is false).
+//
+//  To measure a frame, take a snapshot at its start, reset the peak, and
+//  subtract the start from a snapshot at its end with allocDelta().
+//
+const int allocMaxTags = 32;
+
+struct AllocSnapshot {
+	int tags;							// tags registered
+	uint64_t allocs[allocMaxTags];		// allocations, per tag
+	uint64_t bytes[allocMaxTags];		// bytes allocated, per tag
+	uint64_t frees[allocMaxTags];		// frees of blocks allocated with the tag
+	int64_t live;						// bytes allocated and not yet freed
+	int64_t peak;						// most live bytes since allocResetPeak()
+};
+
+bool allocTrackingEnabled();
+int allocTag(const char *name);			// register a tag (name isn't copied)
+const char *allocTagName(int tag);
+void allocSnapshot(AllocSnapshot & s);
+void allocResetPeak();
+AllocSnapshot allocDelta(const AllocSnapshot & before, const AllocSnapshot & after);
+uint64_t allocTotal(const AllocSnapshot & s);	// allocations over all tags
+
+//  Sets the calling thread's tag for its lifetime
+//
+class AllocTagScope {
+public:
+	AllocTagScope(int tag);
+	~AllocTagScope();
+private:
+	int previous;
+};
+
+#ifdef LANDER_TRACK_ALLOCS
+#define ALLOC_CONCAT2(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT2(a, b)
+#define ALLOC_TAG(name) \
+	static const int ALLOC_CONCAT(allocTagId, __LINE__) = allocTag(name); \
+	AllocTagScope ALLOC_CONCAT(allocTagScope, __LINE__)(ALLOC_CONCAT(allocTagId, __LINE__))
+#else
+#define ALLOC_TAG(name)
+#endif
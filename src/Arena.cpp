@@ -0,0 +1,58 @@
+#include "Arena.h"
+#include <stdlib.h>
+#include <new>
+
+Arena::Arena(size_t capacity) {
+	size = capacity;
+	block = (char *)malloc(size);
+	if (!block) throw std::bad_alloc();
+	offset = 0;
+	overflowBytes = 0;
+	peak = 0;
+}
+
+Arena::~Arena() {
+	reset();
+	free(block);
+}
+
+void *Arena::alloc(size_t n, size_t align) {
+	// align the address rather than the offset: malloc only aligns the
+	// block to max_align_t, and over-aligned types can ask for more
+	//
+	size_t base = (size_t)block;
+	size_t start = ((base + offset + align - 1) & ~(align - 1)) - base;
+	if (start + n <= size) {
+		offset = start + n;
+		if (used() > peak) peak = used();
+		return block + start;
+	}
+
+	// the block is full: take this one from the heap until the next reset
+	//
+	void *p = malloc(n + align);
+	if (!p) throw std::bad_alloc();
+	overflow.push_back(p);
+	overflowBytes += n + align;
+	if (used() > peak) peak = used();
+	return (void *)(((size_t)p + align - 1) & ~(align - 1));
+}
+
+//  Free everything.  If the block overflowed, grow it so that much fits
+//  next time.
+//
+void Arena::reset() {
+	if (!overflow.empty()) {
+		for (int i = 0; i < overflow.size(); i++) free(overflow[i]);
+		overflow.clear();
+		size_t grown = size + overflowBytes;
+		char *p = (char *)malloc(grown);
+		if (p) {
+			free(block);
+			block = p;
+			size = grown;
+		}
+		overflowBytes = 0;
+	}
+	offset = 0;
+}
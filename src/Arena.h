@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+//  Bump allocator for transient data.
+//
+//  alloc() hands out memory from one block by moving an offset, and reset()
+//  frees everything at once by moving it back, so memory that only lives
+//  for a tick or a frame costs no malloc/free.  Destructors are not run;
+//  only put trivially destructible data (or containers whose lifetime ends
+//  before the reset) in an arena.
+//
+//  If a frame needs more than the block holds, the extra comes from
+//  separate heap chunks, and the next reset() grows the block to cover it,
+//  so the arena settles at the largest frame's size.
+//
+class Arena {
+public:
+	Arena(size_t capacity = 64 * 1024);
+	~Arena();
+	Arena(const Arena &) = delete;
+	Arena & operator=(const Arena &) = delete;
+
+	void *alloc(size_t size, size_t align = alignof(max_align_t));
+	void reset();
+	size_t used() const { return offset + overflowBytes; }
+	size_t capacity() const { return size; }
+	size_t peak;			// most bytes used between resets
+
+private:
+	char *block;
+	size_t size;
+	size_t offset;
+	std::vector<void *> overflow;	// chunks allocated after the block filled
+	size_t overflowBytes;
+};
+
+//  STL allocator that takes memory from an arena, e.g.
+//
+//      vector<float, ArenaAllocator<float>> xs((ArenaAllocator<float>(arena)));
+//
+//  deallocate() does nothing; the memory comes back when the arena is
+//  reset, so the container must not be used after that.
+//
+template <typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	ArenaAllocator(Arena & arena) : arena(&arena) {}
+	template <typename U> ArenaAllocator(const ArenaAllocator<U> & other) : arena(other.arena) {}
+
+	T *allocate(size_t n) { return (T *)arena->alloc(n * sizeof(T), alignof(T)); }
+	void deallocate(T *, size_t) {}
+
+	template <typename U> bool operator==(const ArenaAllocator<U> & other) const { return arena == other.arena; }
+	template <typename U> bool operator!=(const ArenaAllocator<U> & other) const { return arena != other.arena; }
+
+	Arena *arena;
+};
@@ -0,0 +1,213 @@
+#include "AssetLoader.h"
+#include "Log.h"
+#include <mutex>
+
+//  openFrameworks' sound player sets up the sound system the first time
+//  anything is loaded and isn't safe to load from two threads at once, so
+//  sounds load one at a time (still alongside the image decoding).
+//
+static std::mutex soundLock;
+
+static const char *kindName[] = { "image", "sound", "font", "sample" };
+
+AssetLoader::AssetLoader() {
+	pool = NULL;
+	pack = NULL;
+	readyTime = 0;
+	done = 0;
+	failures = 0;
+}
+
+//  Deleting the pool waits for any decodes still running
+//
+AssetLoader::~AssetLoader() {
+	delete pool;
+	for (int i = 0; i < assets.size(); i++) delete assets[i];
+}
+
+void AssetLoader::image(const string & path, ofImage *target) {
+	request(AssetImage, path, 0, target);
+}
+
+void AssetLoader::sound(const string & path, ofSoundPlayer *target) {
+	request(AssetSound, path, 0, target);
+}
+
+void AssetLoader::sample(const string & path, AudioSample *target) {
+	request(AssetSample, path, 0, target);
+}
+
+void AssetLoader::font(const string & path, int size, ofTrueTypeFont *target) {
+	request(AssetFont, path, size, target);
+}
+
+//  Add a target to the asset for this file, or a new asset if there
+//  isn't one yet
+//
+AssetLoader::Asset *AssetLoader::request(AssetKind kind, const string & path, int size, void *target) {
+	for (int i = 0; i < assets.size(); i++) {
+		Asset *a = assets[i];
+		if (a->kind != kind || a->path != path || a->size != size) continue;
+		if (std::find(a->targets.begin(), a->targets.end(), target) == a->targets.end()) {
+			a->targets.push_back(target);
+		}
+		return a;
+	}
+	Asset *a = new Asset();
+	a->kind = kind;
+	a->path = path;
+	a->size = size;
+	a->targets.push_back(target);
+	a->loader = this;
+	assets.push_back(a);
+	return a;
+}
+
+//  Queue the images and sounds on the workers.  Fonts have nothing to do
+//  off the main thread, and packed images and samples are already decoded,
+//  so they're ready for update() straight away.
+//
+void AssetLoader::start(int threads) {
+	startTime = std::chrono::steady_clock::now();
+	pool = new ThreadPool(max(threads, 1));
+
+	// submitted in reverse as the pool runs the newest job first
+	//
+	for (int i = assets.size() - 1; i >= 0; i--) {
+		Asset *a = assets[i];
+		const AssetPackEntry *e = pack && a->kind != AssetFont ? pack->find(a->path) : NULL;
+		if (e && a->kind == AssetImage && e->kind == AssetPackPixels) {
+			a->pixels.setFromExternalPixels((unsigned char *)pack->data(*e), e->width, e->height, e->channels);
+			a->packed = true;
+			a->state = AssetDecoded;
+		}
+		else if (e && a->kind == AssetSample && e->kind == AssetPackPCM) {
+			a->sample.frames = (const int16_t *)pack->data(*e);
+			a->sample.frameCount = e->width;
+			a->sample.channels = e->channels;
+			a->sample.sampleRate = e->sampleRate;
+			a->packed = true;
+			a->state = AssetDecoded;
+		}
+		else if (a->kind == AssetFont) a->state = AssetDecoded;
+		else pool->submit(decode, a);
+	}
+}
+
+//  Worker thread: decode an image to pixels or a WAV to samples, or load a
+//  sound into its players
+//
+void AssetLoader::decode(void *arg) {
+	Asset *a = (Asset *)arg;
+	a->started = a->loader->now();
+
+	bool ok = true;
+	if (a->kind == AssetImage) {
+		ok = ofLoadImage(a->pixels, a->path);
+	}
+	else if (a->kind == AssetSample) {
+		AudioSample & s = a->sample;
+		ok = readWav(ofToDataPath(a->path), s.samples, s.channels, s.sampleRate) && !s.samples.empty();
+		if (ok) {
+			s.frames = &s.samples[0];
+			s.frameCount = s.samples.size() / s.channels;
+		}
+	}
+	else {
+		std::lock_guard<std::mutex> guard(soundLock);
+		for (int i = 0; i < a->targets.size() && ok; i++) {
+			ok = ((ofSoundPlayer *)a->targets[i])->load(a->path);
+		}
+	}
+
+	a->decoded = a->loader->now();
+	a->state = ok ? AssetDecoded : AssetFailed;
+}
+
+//  Finish whatever the workers have decoded since last time: textures
+//  are uploaded and fonts are loaded here.  Fonts take a while, so only
+//  one is loaded per call to keep the loading screen moving.
+//
+bool AssetLoader::update() {
+	bool loadedFont = false;
+	for (int i = 0; i < assets.size(); i++) {
+		Asset *a = assets[i];
+		int state = a->state;
+		if (state == AssetFailed && a->finished == 0) {
+			a->finished = now();
+			failures++;
+			LOG_ERROR("Can't load %s file: %s", kindName[a->kind], a->path.c_str());
+		}
+		if (state != AssetDecoded) continue;
+		if (a->kind == AssetFont) {
+			if (loadedFont) continue;
+			loadedFont = true;
+		}
+		finish(a);
+	}
+
+	if (done + failures < assets.size()) return false;
+	if (pool) {
+		delete pool;
+		pool = NULL;
+		readyTime = now();
+	}
+	return failures == 0;
+}
+
+//  Main thread: hand the decoded asset to its targets
+//
+void AssetLoader::finish(Asset *a) {
+	bool ok = true;
+	switch (a->kind) {
+	case AssetImage:
+		for (int i = 0; i < a->targets.size(); i++) ((ofImage *)a->targets[i])->setFromPixels(a->pixels);
+		a->pixels = ofPixels();
+		break;
+	case AssetSound:
+		break;
+	case AssetSample:
+		for (int i = 0; i < a->targets.size(); i++) {
+			AudioSample *s = (AudioSample *)a->targets[i];
+			*s = a->sample;
+			s->name = a->path;
+			if (!s->samples.empty()) s->frames = &s->samples[0];
+		}
+		a->sample = AudioSample();
+		break;
+	case AssetFont: {
+		a->started = now();
+		ofTrueTypeFont *first = (ofTrueTypeFont *)a->targets[0];
+		ok = first->load(a->path, a->size, true, true);
+		for (int i = 1; i < a->targets.size() && ok; i++) *(ofTrueTypeFont *)a->targets[i] = *first;
+		a->decoded = now();
+		break;
+	}
+	}
+
+	if (!ok) {
+		a->state = AssetFailed;		// reported by update()
+		return;
+	}
+	a->finished = now();
+	a->state = AssetDone;
+	done++;
+}
+
+double AssetLoader::now() const {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//  One line per asset: time waiting for a worker, decoding, and waiting
+//  for the main thread to finish it
+//
+void AssetLoader::report() const {
+	for (int i = 0; i < assets.size(); i++) {
+		const Asset *a = assets[i];
+		LOG_INFO("Asset %-5s %-28s wait %7.1f ms, load %7.1f ms, finish %7.1f ms (%d target%s%s)",
+			kindName[a->kind], a->path.c_str(), a->started, a->decoded - a->started,
+			a->finished - a->decoded, (int)a->targets.size(), a->targets.size() == 1 ? "" : "s",
+			a->packed ? ", packed" : "");
+	}
+	LOG_INFO("Assets: %d loaded in %.1f ms", done, readyTime);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ThreadPool.h"
+#include "AssetPack.h"
+#include "AudioManager.h"
+#include <atomic>
+#include <chrono>
+
+//  Loads the app's images, sounds and fonts in the background so decoding
+//  them doesn't hold up the first frame.
+//
+//  Each request names a file and the object to load it into.  Images are
+//  decoded to pixels, sound effects to PCM for the AudioManager, and
+//  sounds are loaded into their players on worker threads; uploading
+//  the textures and loading fonts need the GL context, so update() does
+//  those on the main thread as each asset becomes ready.  Requests for a
+//  file already requested (at the same size, for fonts) load it once and
+//  copy the result to every target.
+//
+//  Images and sound effects found in an asset pack given to usePack() skip
+//  decoding: their pixels or samples are used in place in the pack's
+//  mapping.
+//
+//  The time each asset spent waiting for a worker and loading is kept for
+//  report(), along with the time from start() until everything was ready.
+//
+class AssetLoader {
+public:
+	AssetLoader();
+	~AssetLoader();
+	AssetLoader(const AssetLoader &) = delete;
+	AssetLoader & operator=(const AssetLoader &) = delete;
+
+	// requests, before start()
+	//
+	void image(const string & path, ofImage *target);
+	void sound(const string & path, ofSoundPlayer *target);
+	void sample(const string & path, AudioSample *target);		// a WAV, for AudioManager::add()
+	void font(const string & path, int size, ofTrueTypeFont *target);
+	void usePack(const AssetPack *pack) { this->pack = pack; }
+
+	void start(int threads);
+	bool update();				// main thread, each frame; true once all have loaded
+	bool failed() const { return failures > 0; }
+	int loaded() const { return done; }
+	int count() const { return assets.size(); }
+	void report() const;		// log the load times
+
+private:
+	enum AssetKind { AssetImage, AssetSound, AssetFont, AssetSample };
+	enum AssetState { AssetQueued, AssetDecoded, AssetDone, AssetFailed };
+
+	struct Asset {
+		AssetKind kind;
+		string path;
+		int size;					// fonts
+		bool packed;				// found in the pack
+		vector<void *> targets;
+		ofPixels pixels;			// images, decoded by a worker
+		AudioSample sample;			// samples, decoded by a worker or in the pack
+		std::atomic<int> state;
+		double started, decoded, finished;	// ms since start()
+		AssetLoader *loader;
+		Asset() : size(0), packed(false), state(AssetQueued), started(0), decoded(0), finished(0), loader(NULL) {}
+	};
+	vector<Asset *> assets;
+	ThreadPool *pool;
+	const AssetPack *pack;
+	std::chrono::steady_clock::time_point startTime;
+	double readyTime;			// ms from start() until all were loaded
+	int done;
+	int failures;
+
+	Asset *request(AssetKind kind, const string & path, int size, void *target);
+	void finish(Asset *asset);
+	double now() const;
+	static void decode(void *asset);
+};
@@ -0,0 +1,116 @@
+#include "AssetPack.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::AssetPack() {
+	header = 0;
+	entries = 0;
+	size = 0;
+#ifdef _WIN32
+	file = 0;
+	mapping = 0;
+#endif
+}
+
+AssetPack::~AssetPack() {
+	close();
+}
+
+//  The bytes an entry's kind and dimensions call for, or 0 if they make no
+//  sense, so a stale or damaged pack can't send a reader past its data
+//
+static uint64_t expectedSize(const AssetPackEntry & e) {
+	if (e.width == 0 || e.channels == 0) return 0;
+	if (e.kind == AssetPackPixels) return e.height > 0 && e.channels <= 4 ? (uint64_t)e.width * e.height * e.channels : 0;
+	if (e.kind == AssetPackPCM) return e.width <= INT32_MAX ? (uint64_t)e.width * e.channels * sizeof(int16_t) : 0;
+	return 0;
+}
+
+//  Map the whole file read only and check the header and index fit in it,
+//  and that each entry's size matches what it describes.  The data itself
+//  isn't touched until it's used.
+//
+bool AssetPack::open(const std::string & path) {
+	close();
+
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		file = 0;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(file, &fileSize);
+	size = (size_t)fileSize.QuadPart;
+	mapping = size > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : 0;
+	void *p = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+	if (!p) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		mapping = 0;
+		file = 0;
+		return false;
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	size = st.st_size;
+	void *p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) return false;
+#endif
+
+	header = (const AssetPackHeader *)p;
+	entries = (const AssetPackEntry *)(header + 1);
+	bool valid = size >= sizeof(AssetPackHeader) && header->magic == assetPackMagic &&
+		header->version == assetPackVersion &&
+		sizeof(AssetPackHeader) + (uint64_t)header->count * sizeof(AssetPackEntry) <= size;
+	for (int i = 0; valid && i < header->count; i++) {
+		valid = entries[i].offset <= size && entries[i].size <= size - entries[i].offset &&
+			memchr(entries[i].name, 0, assetPackNameLength) != NULL &&
+			entries[i].size == expectedSize(entries[i]) && entries[i].size > 0;
+	}
+	if (!valid) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void AssetPack::close() {
+	if (!header) return;
+#ifdef _WIN32
+	UnmapViewOfFile(header);
+	CloseHandle(mapping);
+	CloseHandle(file);
+	mapping = 0;
+	file = 0;
+#else
+	munmap((void *)header, size);
+#endif
+	header = 0;
+	entries = 0;
+	size = 0;
+}
+
+//  The entry for the asset at this path under data/, or NULL
+//
+const AssetPackEntry *AssetPack::find(const std::string & name) const {
+	for (int i = 0; i < count(); i++) {
+		if (name == entries[i].name) return &entries[i];
+	}
+	return NULL;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+//  Pre-decoded asset pack.
+//
+//  `lunarlander --pack` decodes the images and sounds under data/ once and
+//  writes them to a single file (data/assets.pack by default): a header,
+//  an index of entries and then each asset's data, 64 byte aligned.
+//  Images are stored as 8 bit RGBA rows, ready to upload as a texture;
+//  sounds as interleaved 16 bit PCM.
+//
+//  At run time AssetPack maps the file read only and hands out pointers
+//  straight into the mapping, so loading an asset costs the page faults
+//  to touch it rather than decoding it.  The layout is plain fixed size
+//  types in the machine's byte order; bump assetPackVersion when it
+//  changes.
+//
+//  This header doesn't include ofMain.h so tools can use it.
+//
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+const uint32_t assetPackMagic = 0x4b50414c;		// "LAPK"
+const uint32_t assetPackVersion = 1;
+const int assetPackAlign = 64;
+const int assetPackNameLength = 64;
+
+enum AssetPackKind {
+	AssetPackPixels = 1,		// width x height x channels bytes
+	AssetPackPCM = 2			// width frames x channels int16_t samples
+};
+
+struct AssetPackHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t count;				// entries following the header
+	uint32_t pad;
+};
+
+struct AssetPackEntry {
+	char name[assetPackNameLength];		// path under data/, e.g. "images/ship.png"
+	uint32_t kind;				// AssetPackKind
+	uint32_t width;				// pixels, or frames for PCM
+	uint32_t height;			// pixels, 0 for PCM
+	uint32_t channels;
+	uint32_t sampleRate;		// PCM, Hz
+	uint32_t pad;
+	uint64_t offset;			// of the data from the start of the file
+	uint64_t size;				// bytes
+};
+
+class AssetPack {
+public:
+	AssetPack();
+	~AssetPack();
+	AssetPack(const AssetPack &) = delete;
+	AssetPack & operator=(const AssetPack &) = delete;
+
+	bool open(const std::string & path);
+	void close();
+	bool isOpen() const { return header != 0; }
+
+	int count() const { return header ? header->count : 0; }
+	const AssetPackEntry & entry(int i) const { return entries[i]; }
+	const AssetPackEntry *find(const std::string & name) const;
+	const void *data(const AssetPackEntry & e) const { return (const char *)header + e.offset; }
+
+private:
+	const AssetPackHeader *header;
+	const AssetPackEntry *entries;
+	size_t size;
+#ifdef _WIN32
+	void *file;
+	void *mapping;
+#endif
+};
@@ -0,0 +1,121 @@
+#include "ofMain.h"
+#include "AssetPacker.h"
+#include "AssetPack.h"
+#include "AudioManager.h"
+#include "Log.h"
+#include <fstream>
+#include <string.h>
+
+//  One asset decoded and waiting to be written
+//
+struct PackItem {
+	AssetPackEntry entry;
+	vector<char> data;
+};
+
+//  Decode an image to RGBA, whatever its format in the file
+//
+static bool packImage(const string & path, PackItem & item) {
+	ofPixels pixels;
+	if (!ofLoadImage(pixels, path)) return false;
+	pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+
+	item.entry.kind = AssetPackPixels;
+	item.entry.width = pixels.getWidth();
+	item.entry.height = pixels.getHeight();
+	item.entry.channels = pixels.getNumChannels();
+	const char *p = (const char *)pixels.getData();
+	item.data.assign(p, p + pixels.getTotalBytes());
+	return true;
+}
+
+//  Pull the samples out of a 16 bit PCM WAV file
+//
+static bool packWav(const string & path, PackItem & item) {
+	vector<int16_t> samples;
+	int channels, sampleRate;
+	if (!readWav(path, samples, channels, sampleRate) || samples.empty()) return false;
+
+	item.entry.kind = AssetPackPCM;
+	item.entry.width = samples.size() / channels;
+	item.entry.height = 0;
+	item.entry.channels = channels;
+	item.entry.sampleRate = sampleRate;
+	const char *p = (const char *)&samples[0];
+	item.data.assign(p, p + samples.size() * sizeof(int16_t));
+	return true;
+}
+
+//  Decode every file with this extension in a directory under data/
+//
+static bool packDirectory(const string & dir, const string & ext, bool (*pack)(const string &, PackItem &),
+	vector<PackItem> & items) {
+	ofDirectory listing(ofToDataPath(dir));
+	listing.allowExt(ext);
+	listing.listDir();
+	listing.sort();
+	for (int i = 0; i < listing.size(); i++) {
+		string name = dir + "/" + listing.getName(i);
+		if (name.size() >= assetPackNameLength) {
+			LOG_ERROR("Asset name too long to pack: %s", name.c_str());
+			return false;
+		}
+
+		PackItem item;
+		memset(&item.entry, 0, sizeof(item.entry));
+		strcpy(item.entry.name, name.c_str());
+		if (!pack(listing.getPath(i), item)) {
+			LOG_ERROR("Can't pack %s", name.c_str());
+			return false;
+		}
+		items.push_back(item);
+	}
+	return true;
+}
+
+int runPack(const string & path) {
+	vector<PackItem> items;
+	if (!packDirectory("images", "png", packImage, items) ||
+		!packDirectory("sounds", "wav", packWav, items)) {
+		return 1;
+	}
+
+	// lay out the data after the index, each asset aligned for the GPU
+	// upload and SIMD reads
+	//
+	AssetPackHeader header = {};
+	header.magic = assetPackMagic;
+	header.version = assetPackVersion;
+	header.count = items.size();
+	uint64_t offset = sizeof(header) + items.size() * sizeof(AssetPackEntry);
+	for (int i = 0; i < items.size(); i++) {
+		offset = (offset + assetPackAlign - 1) / assetPackAlign * assetPackAlign;
+		items[i].entry.offset = offset;
+		items[i].entry.size = items[i].data.size();
+		offset += items[i].data.size();
+	}
+
+	ofstream out(path.c_str(), ios::binary);
+	out.write((const char *)&header, sizeof(header));
+	for (int i = 0; i < items.size(); i++) out.write((const char *)&items[i].entry, sizeof(AssetPackEntry));
+	for (int i = 0; i < items.size(); i++) {
+		static const char zeros[assetPackAlign] = {};
+		out.write(zeros, items[i].entry.offset - out.tellp());
+		if (!items[i].data.empty()) out.write(&items[i].data[0], items[i].data.size());
+	}
+	out.close();
+	if (!out) {
+		LOG_ERROR("Can't write asset pack: %s", path.c_str());
+		return 1;
+	}
+
+	for (int i = 0; i < items.size(); i++) {
+		const AssetPackEntry & e = items[i].entry;
+		cout << "pack: " << e.name << ", ";
+		if (e.kind == AssetPackPixels) cout << e.width << "x" << e.height << " RGBA";
+		else cout << e.width << " frames x " << e.channels << " channels at " << e.sampleRate << " Hz";
+		cout << ", " << e.size << " bytes" << endl;
+	}
+	cout << "pack: " << items.size() << " assets, " << offset << " bytes to " << path << endl;
+	return 0;
+}
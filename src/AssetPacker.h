@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+using std::string;
+
+//  Decode the PNG images under data/images and the WAV sounds under
+//  data/sounds and write them to an asset pack (see AssetPack.h) for the
+//  game to map at startup instead of decoding them again.  Other files
+//  (the MP3 music and the fonts) are left to load from data/ as before.
+//
+//  Run this again whenever the assets change: the game uses whatever is
+//  in the pack over the source files.
+//
+//  Returns a process exit code.
+//
+int runPack(const string & path);
@@ -0,0 +1,203 @@
+#include "AudioManager.h"
+#include "Log.h"
+#include <fstream>
+#include <string.h>
+
+static uint32_t readLE32(const unsigned char *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t readLE16(const unsigned char *p) {
+	return p[0] | (p[1] << 8);
+}
+
+//  The chunks are walked rather than assuming the usual 44 byte header,
+//  since tools often add LIST or fact chunks before the data
+//
+bool readWav(const string & path, vector<int16_t> & samples, int & channels, int & sampleRate) {
+	ifstream in(path.c_str(), ios::binary);
+	if (!in) return false;
+	vector<char> file((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	if (file.size() < 12) return false;
+	const unsigned char *p = (const unsigned char *)&file[0];
+	if (memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) return false;
+
+	const unsigned char *fmt = NULL, *data = NULL;
+	uint32_t dataSize = 0;
+	size_t at = 12;
+	while (at + 8 <= file.size()) {
+		uint32_t chunkSize = readLE32(p + at + 4);
+		if (chunkSize > file.size() - at - 8) chunkSize = file.size() - at - 8;
+		if (memcmp(p + at, "fmt ", 4) == 0 && chunkSize >= 16) fmt = p + at + 8;
+		if (memcmp(p + at, "data", 4) == 0) {
+			data = p + at + 8;
+			dataSize = chunkSize;
+		}
+		at += 8 + chunkSize + (chunkSize & 1);
+	}
+	if (!fmt || !data) return false;
+
+	int format = readLE16(fmt);
+	channels = readLE16(fmt + 2);
+	sampleRate = readLE32(fmt + 4);
+	int bits = readLE16(fmt + 14);
+	if (format != 1 || bits != 16 || channels == 0) {
+		LOG_WARNING("Only 16 bit PCM WAV files are supported: %s", path.c_str());
+		return false;
+	}
+
+	int count = dataSize / (2 * channels) * channels;
+	samples.resize(count);
+	for (int i = 0; i < count; i++) samples[i] = (int16_t)readLE16(data + i * 2);
+	return true;
+}
+
+AudioManager::AudioManager(int voices, int sampleRate, int channels) :
+	sampleRate(sampleRate), channels(channels) {
+	Voice v = {};
+	this->voices.assign(voices, v);
+	mixes = 0;
+	stats.triggers = 0;
+	stats.coalesced = 0;
+	stats.started = 0;
+	stats.stolen = 0;
+	stats.dropped = 0;
+	stats.active = 0;
+}
+
+AudioManager::~AudioManager() {
+	for (int i = 0; i < samples.size(); i++) delete samples[i];
+}
+
+//  Add a sound whose samples stay where they are: in a pack's mapping or
+//  memory the caller keeps until the manager is gone
+//
+int AudioManager::add(const string & name, const int16_t *frames, int frameCount, int channels, int sampleRate) {
+	AudioSample *s = new AudioSample();
+	s->name = name;
+	s->frames = frames;
+	s->frameCount = frameCount;
+	s->channels = channels;
+	s->sampleRate = sampleRate;
+	s->volume = 1;
+	samples.push_back(s);
+	pending.push_back(0);
+	return samples.size() - 1;
+}
+
+//  Its frames stay where they are, so the sample has to outlive the
+//  manager
+//
+int AudioManager::add(const AudioSample & sound) {
+	return add(sound.name, sound.frames, sound.frameCount, sound.channels, sound.sampleRate);
+}
+
+void AudioManager::setVolume(int sound, float volume) {
+	if (sound < 0 || sound >= samples.size()) return;
+	samples[sound]->volume = volume;
+}
+
+void AudioManager::play(int sound, float volume) {
+	if (sound < 0 || sound >= samples.size()) return;
+	stats.triggers.fetch_add(1, std::memory_order_relaxed);
+	if (pending[sound] > 0) stats.coalesced.fetch_add(1, std::memory_order_relaxed);
+	pending[sound] = max(pending[sound], max(volume, 1e-6f));
+}
+
+void AudioManager::update() {
+	for (int i = 0; i < pending.size(); i++) {
+		if (pending[i] == 0) continue;
+		AudioCommand c = { i, pending[i] };
+		if (!commands.push(c)) stats.dropped.fetch_add(1, std::memory_order_relaxed);
+		pending[i] = 0;
+	}
+}
+
+//  Start a voice for a sound, stealing the one that has played longest if
+//  none are free
+//
+void AudioManager::start(const AudioCommand & command) {
+	Voice *v = NULL;
+	for (int i = 0; i < voices.size(); i++) {
+		if (!voices[i].sample) {
+			v = &voices[i];
+			break;
+		}
+		if (!v || voices[i].startedAt < v->startedAt) v = &voices[i];
+	}
+	if (!v) return;
+	if (v->sample) stats.stolen.fetch_add(1, std::memory_order_relaxed);
+
+	const AudioSample *s = samples[command.sound];
+	v->sample = s;
+	v->position = 0;
+	v->step = ((uint64_t)s->sampleRate << 32) / sampleRate;
+	v->volume = command.volume * s->volume;
+	v->startedAt = mixes;
+	stats.started.fetch_add(1, std::memory_order_relaxed);
+}
+
+//  Add up the playing voices, resampling each to the output rate with
+//  linear interpolation.  A mono sample plays on every output channel.
+//
+void AudioManager::mix(float *out, int frames) {
+	AudioCommand c;
+	while (commands.pop(c)) start(c);
+	mixes++;
+
+	memset(out, 0, frames * channels * sizeof(float));
+	int active = 0;
+	for (int i = 0; i < voices.size(); i++) {
+		Voice & v = voices[i];
+		const AudioSample *s = v.sample;
+		if (!s) continue;
+
+		const float scale = v.volume / 32768.0f;
+		const int last = s->frameCount - 1;
+		int f = 0;
+		for (; f < frames; f++) {
+			int index = v.position >> 32;
+			if (index > last) break;
+			float frac = (v.position & 0xffffffff) * (1.0f / 4294967296.0f);
+			const int16_t *a = s->frames + index * s->channels;
+			const int16_t *b = index < last ? a + s->channels : a;
+			for (int ch = 0; ch < channels; ch++) {
+				int sc = min(ch, s->channels - 1);
+				out[f * channels + ch] += (a[sc] + (b[sc] - a[sc]) * frac) * scale;
+			}
+			v.position += v.step;
+		}
+		if (f < frames) v.sample = NULL;
+		else active++;
+	}
+
+	for (int i = 0; i < frames * channels; i++) out[i] = ofClamp(out[i], -1, 1);
+	stats.active.store(active, std::memory_order_relaxed);
+}
+
+void NullAudioBackend::render(int frames) {
+	buffer.resize(frames * audio.channels);
+	if (frames > 0) audio.mix(&buffer[0], frames);
+}
+
+bool StreamAudioBackend::start(AudioManager & audio, int bufferSize) {
+	this->audio = &audio;
+	ofSoundStreamSettings settings;
+	settings.setOutListener(this);
+	settings.numOutputChannels = audio.channels;
+	settings.numInputChannels = 0;
+	settings.sampleRate = audio.sampleRate;
+	settings.bufferSize = bufferSize;
+	settings.numBuffers = 4;
+	return stream.setup(settings);
+}
+
+void StreamAudioBackend::stop() {
+	stream.close();
+}
+
+void StreamAudioBackend::audioOut(ofSoundBuffer & buffer) {
+	if (audio && buffer.getNumChannels() == audio->channels) {
+		audio->mix(&buffer[0], buffer.getNumFrames());
+	}
+}
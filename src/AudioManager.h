@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ofMain.h"
+#include "SpscQueue.h"
+#include <atomic>
+
+//  A sound decoded to 16 bit PCM, shared by every voice playing it.
+//  frames points into the asset pack's mapping or at samples.
+//
+struct AudioSample {
+	string name;
+	const int16_t *frames;		// interleaved
+	int frameCount;
+	int channels;
+	int sampleRate;
+	float volume;				// applied to every play
+	vector<int16_t> samples;	// decoded here when not from a pack
+};
+
+//  Read the samples from a 16 bit PCM WAV file
+//
+bool readWav(const string & path, vector<int16_t> & samples, int & channels, int & sampleRate);
+
+//  Plays the game's sound effects from a fixed pool of voices, mixing them
+//  in software into whatever backend pulls audio from mix().
+//
+//  Sounds are decoded once by an AssetLoader (or used in place from an
+//  asset pack) and shared by all the voices playing them.  The
+//  game calls play() from the main thread as often as it likes; identical
+//  triggers within a frame are coalesced into one voice, at the loudest
+//  volume asked for, when update() sends the frame's triggers to the audio
+//  thread through a lock free queue.  If every voice is busy the one that
+//  has played longest is stolen.
+//
+//  The voices belong to the audio thread (mix()); the main thread only
+//  sees the counts in stats.
+//
+class AudioManager {
+public:
+	AudioManager(int voices = 16, int sampleRate = 44100, int channels = 2);
+	~AudioManager();
+	AudioManager(const AudioManager &) = delete;
+	AudioManager & operator=(const AudioManager &) = delete;
+
+	// before the backend starts
+	//
+	int add(const string & name, const int16_t *frames, int frameCount, int channels, int sampleRate);
+	int add(const AudioSample & sound);		// decoded by an AssetLoader
+	void setVolume(int sound, float volume);
+
+	// main thread
+	//
+	void play(int sound, float volume = 1);
+	void update();				// once a frame: start this frame's sounds
+
+	// audio thread: mix frames frames of interleaved output into out
+	//
+	void mix(float *out, int frames);
+
+	const int sampleRate;
+	const int channels;
+
+	struct Stats {
+		std::atomic<unsigned long> triggers;	// play() calls
+		std::atomic<unsigned long> coalesced;	// play() calls merged into another
+		std::atomic<unsigned long> started;		// voices started
+		std::atomic<unsigned long> stolen;		// voices cut off to start another
+		std::atomic<unsigned long> dropped;		// triggers lost to a full queue
+		std::atomic<int> active;				// voices playing after the last mix
+	} stats;
+
+private:
+	struct Voice {
+		const AudioSample *sample;	// NULL when free
+		uint64_t position;			// frames into the sample, 32.32 fixed point
+		uint64_t step;				// sample frames per output frame, 32.32
+		float volume;
+		unsigned long startedAt;	// mix() call it started in
+	};
+	struct AudioCommand {
+		int sound;
+		float volume;
+	};
+
+	vector<AudioSample *> samples;
+	vector<float> pending;		// loudest volume asked for this frame, per sound (0 if none)
+	vector<Voice> voices;
+	SpscQueue<AudioCommand, 64> commands;
+	unsigned long mixes;
+
+	void start(const AudioCommand & command);
+};
+
+//  Backend with no audio device: render() mixes into a buffer that's
+//  thrown away, so the manager can run headless (benchmarks, CI).
+//
+class NullAudioBackend {
+public:
+	NullAudioBackend(AudioManager & audio) : audio(audio) {}
+	void render(int frames);
+	const vector<float> & output() const { return buffer; }
+
+private:
+	AudioManager & audio;
+	vector<float> buffer;
+};
+
+//  Backend playing through the default sound card with an ofSoundStream
+//
+class StreamAudioBackend : public ofBaseSoundOutput {
+public:
+	StreamAudioBackend() : audio(NULL) {}
+	bool start(AudioManager & audio, int bufferSize = 512);
+	void stop();
+	void audioOut(ofSoundBuffer & buffer);
+
+private:
+	AudioManager *audio;
+	ofSoundStream stream;
+};
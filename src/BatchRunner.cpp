@@ -0,0 +1,112 @@
+#include "BatchRunner.h"
+#include "GameWorld.h"
+#include "Headless.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+BatchRunner::BatchRunner(int worlds, int rounds, int threads, uint64_t seed) {
+	this->worlds = worlds;
+	this->rounds = rounds;
+	this->threads = threads;
+	this->seed = seed;
+	ticks = 0;
+	seconds = 0;
+}
+
+//  Play all the rounds of world i and store its scores and tick count
+//
+void BatchRunner::runWorld(int i) {
+	const float tickLength = 1.0 / 60;
+
+	GameWorld world;
+	world.setSeed(Random::stream(seed, i));
+	world.setup(750, 1334);
+
+	int played = 0;
+	while (played < rounds) {
+		scriptInput(world, world.ticks);
+
+		bool wasIdle = world.idle;
+		world.step(tickLength);
+		world.shotSounds = 0;
+		world.explosionSounds = 0;
+
+		if (!wasIdle && world.idle) {
+			scores[i * rounds + played] = world.score;
+			world.score = 0;
+			played++;
+		}
+	}
+	worldTicks[i] = world.ticks;
+}
+
+void BatchRunner::run() {
+	int n = threads > 0 ? threads : std::thread::hardware_concurrency();
+	if (n < 1) n = 1;
+
+	scores.assign(worlds * rounds, 0);
+	worldTicks.assign(worlds, 0);
+
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		for (int i = next++; i < worlds; i = next++) {
+			runWorld(i);
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	vector<std::thread> pool;
+	for (int i = 0; i < n; i++) pool.push_back(std::thread(worker));
+	for (int i = 0; i < n; i++) pool[i].join();
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	ticks = 0;
+	for (int i = 0; i < worlds; i++) ticks += worldTicks[i];
+}
+
+//  Throughput plus the distribution of round scores
+//
+void BatchRunner::report(ostream & out) const {
+	int total = scores.size();
+	out << "batch: " << worlds << " worlds x " << rounds << " rounds on "
+		<< (threads > 0 ? threads : (int)std::thread::hardware_concurrency()) << " threads" << endl;
+	out << "batch: " << total << " rounds, " << ticks << " ticks in " << seconds << " sec ("
+		<< (seconds > 0 ? total / seconds : 0) << " rounds/sec, "
+		<< (seconds > 0 ? ticks / seconds : 0) << " ticks/sec)" << endl;
+	if (total == 0) return;
+
+	vector<int> sorted = scores;
+	std::sort(sorted.begin(), sorted.end());
+	double sum = 0;
+	for (int i = 0; i < total; i++) sum += sorted[i];
+	double mean = sum / total;
+	double var = 0;
+	for (int i = 0; i < total; i++) var += (sorted[i] - mean) * (sorted[i] - mean);
+
+	out << "score: mean " << mean << ", stddev " << sqrt(var / total)
+		<< ", min " << sorted.front()
+		<< ", p10 " << sorted[total / 10]
+		<< ", median " << sorted[total / 2]
+		<< ", p90 " << sorted[total * 9 / 10]
+		<< ", max " << sorted.back() << endl;
+
+	// histogram in 10 buckets between min and max
+	//
+	const int buckets = 10;
+	int lo = sorted.front();
+	int width = (sorted.back() - lo) / buckets + 1;
+	int count[buckets] = { 0 };
+	for (int i = 0; i < total; i++) count[(sorted[i] - lo) / width]++;
+	for (int b = 0; b < buckets; b++) {
+		if (count[b] == 0) continue;
+		out << "  " << lo + b * width << "-" << lo + (b + 1) * width - 1 << ": " << count[b] << endl;
+	}
+}
+
+int runBatch(int worlds, int rounds) {
+	BatchRunner batch(worlds, rounds);
+	batch.run();
+	batch.report(cout);
+	return 0;
+}
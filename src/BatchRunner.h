@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ofMain.h"
+
+//  Simulates many independent game worlds across all cores for balance and
+//  load testing.
+//
+//  Each world has its own clock and random seed (world i is seeded with
+//  Random::stream(seed, i), so a batch is reproducible and no two worlds
+//  share random streams) and plays "rounds" rounds with scripted input
+//  (see scriptInput()).  Worlds are handed out to the worker
+//  threads one at a time, so there is no shared state between threads apart
+//  from the work counter and each world's slot in the results.
+//
+class BatchRunner {
+public:
+	BatchRunner(int worlds, int rounds, int threads = 0, uint64_t seed = 1);
+	void run();
+	void report(ostream & out) const;
+
+	int worlds;
+	int rounds;			// rounds played by each world
+	int threads;		// 0 => one per core
+	uint64_t seed;
+
+	// results
+	//
+	vector<int> scores;		// every round's score, world by world
+	long ticks;				// total ticks simulated
+	double seconds;			// wall time for the whole batch
+
+private:
+	void runWorld(int i);
+	vector<long> worldTicks;
+};
+
+int runBatch(int worlds, int rounds);
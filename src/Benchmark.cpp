@@ -0,0 +1,208 @@
+#include "Benchmark.h"
+#include "ParticleSystem.h"
+#include "ParticleEmitter.h"
+#include "Sprite.h"
+#include "GameWorld.h"
+#include "AudioManager.h"
+#include "Log.h"
+#include <chrono>
+
+Benchmark::Benchmark(int maxN, double minTime) {
+	this->maxN = maxN;
+	this->minTime = minTime;
+}
+
+//  Time body() at each size.  Iterations double until a batch takes at
+//  least minTime, which keeps the clock reads out of the per-iteration cost.
+//
+void Benchmark::run(const string & name, std::function<void(int n)> setup, std::function<void()> body) {
+	for (int n = 100; n <= maxN; n *= 10) {
+		setup(n);
+		body();		// warm up caches and grow any scratch buffers
+
+		long iterations = 1;
+		double secs = 0;
+		for (;;) {
+			auto start = std::chrono::steady_clock::now();
+			for (long i = 0; i < iterations; i++) body();
+			secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (secs >= minTime) break;
+			iterations *= 2;
+		}
+
+		BenchResult r;
+		r.name = name;
+		r.n = n;
+		r.iterations = iterations;
+		r.nsPerIteration = secs * 1e9 / iterations;
+		r.nsPerObject = r.nsPerIteration / n;
+		results.push_back(r);
+		LOG_INFO("%s n=%d: %.1f ns (%.2f ns/object)", name.c_str(), n, r.nsPerIteration, r.nsPerObject);
+	}
+}
+
+//  Fill a particle system with n immortal particles spread over the screen.
+//  Damping is off: over thousands of iterations it would decay the
+//  velocities into denormals, which are far slower than the game ever sees.
+//
+static void fillParticles(ParticleSystem & sys, int n, Random & random) {
+	sys.particles.clear();
+	sys.particles.reserve(n);
+	for (int i = 0; i < n; i++) {
+		Particle p;
+		p.position = ofVec3f(random.range(0, 750), random.range(0, 1334), 0);
+		p.velocity = ofVec3f(random.range(-100, 100), random.range(-100, 100), 0);
+		p.lifespan = -1;
+		p.radius = 5;
+		p.damping = 1;
+		sys.add(p);
+	}
+}
+
+//  Fill a sprite system with n immortal sprites spread over the screen
+//
+static void fillSprites(SpriteSystem & sys, int n, Random & random) {
+	sys.clear();
+	sys.sprites.reserve(n);
+	for (int i = 0; i < n; i++) {
+		Sprite s;
+		s.setPosition(glm::vec3(random.range(0, 750), random.range(0, 1334), 0));
+		s.velocity = ofVec3f(0, random.range(-1000, 1000), 0);
+		s.width = 50;
+		s.height = 50;
+		sys.add(s);
+	}
+}
+
+void Benchmark::runAll() {
+	const float dt = 1.0 / 60;
+	Random random;
+
+	// ParticleSystem::update with no forces and then each built-in force
+	//
+	ParticleSystem particles;
+	GravityForce gravity(ofVec3f(0, -10, 0));
+	TurbulenceForce turbulence(ofVec3f(-20, -20, -20), ofVec3f(20, 20, 20));
+	ImpulseRadialForce radial(1000);
+
+	ParticleForce *forces[] = { NULL, &gravity, &turbulence, &radial };
+	const char *forceNames[] = { "none", "gravity", "turbulence", "radial" };
+	for (int f = 0; f < 4; f++) {
+		run(string("ParticleSystem::update/") + forceNames[f],
+			[&](int n) {
+				fillParticles(particles, n, random);
+				particles.forces.clear();
+				if (forces[f]) particles.addForce(forces[f]);
+			},
+			[&]() {
+				particles.reset();		// re-arm the one shot radial impulse
+				particles.update(0, dt, random);
+			});
+	}
+
+	// ParticleBatch::build: the vertex and color arrays for drawing n
+	// particles, without the GL upload
+	//
+	ParticleBatch batch;
+	run("ParticleBatch::build",
+		[&](int n) { fillParticles(particles, n, random); },
+		[&]() { batch.build(particles.particles, 0); });
+
+	// ParticleEmitter::spawn: n radial spawns into an emptied system
+	//
+	ParticleEmitter emitter;
+	emitter.setEmitterType(RadialEmitter);
+	emitter.setVelocity(ofVec3f(100, 100, 0));
+	int spawns = 0;
+	run("ParticleEmitter::spawn",
+		[&](int n) {
+			spawns = n;
+			emitter.sys->particles.reserve(n);
+		},
+		[&]() {
+			emitter.sys->particles.clear();
+			for (int i = 0; i < spawns; i++) emitter.spawn(0, random);
+		});
+
+	// SpriteSystem::update and removeNear (a miss, so the scan is timed and
+	// the system is left intact)
+	//
+	SpriteSystem sprites;
+	run("SpriteSystem::update",
+		[&](int n) { fillSprites(sprites, n, random); },
+		[&]() { sprites.update(0, dt); });
+	run("SpriteSystem::removeNear",
+		[&](int n) { fillSprites(sprites, n, random); },
+		[&]() { sprites.removeNear(ofVec3f(-10000, -10000, 0), 50); });
+
+	// GameWorld::checkCollisions: n missiles against 100 invaders per
+	// invader system (the pass is O(missiles x invaders))
+	//
+	GameWorld world;
+	world.setup(750, 1334);
+	run("GameWorld::checkCollisions",
+		[&](int n) {
+			fillSprites(*world.turret->sys, n, random);
+			for (int i = 0; i < world.invaders.size(); i++) {
+				fillSprites(*world.invaders[i]->sys, 100, random);
+			}
+		},
+		[&]() {
+			world.scratch.reset();		// as step() does
+			world.checkCollisions();
+		});
+
+	// AudioManager: n triggers of two sounds in a frame, then mixing a
+	// 60 Hz frame's worth of audio into the null backend
+	//
+	vector<int16_t> tone(44100 * 2);
+	for (int i = 0; i < tone.size(); i++) tone[i] = random.range(-8000, 8000);
+	AudioManager audio;
+	NullAudioBackend audioOut(audio);
+	int sounds[] = {
+		audio.add("tone44", &tone[0], tone.size() / 2, 2, 44100),
+		audio.add("tone48", &tone[0], tone.size() / 2, 2, 48000)
+	};
+	int triggers = 0;
+	run("AudioManager::play+mix",
+		[&](int n) { triggers = n; },
+		[&]() {
+			for (int i = 0; i < triggers; i++) audio.play(sounds[i & 1]);
+			audio.update();
+			audioOut.render(735);
+		});
+}
+
+void Benchmark::writeCsv(ostream & out) const {
+	out << "name,n,iterations,ns_per_iteration,ns_per_object" << endl;
+	for (int i = 0; i < results.size(); i++) {
+		const BenchResult & r = results[i];
+		out << r.name << "," << r.n << "," << r.iterations << ","
+			<< r.nsPerIteration << "," << r.nsPerObject << endl;
+	}
+}
+
+void Benchmark::writeJson(ostream & out) const {
+	out << "{\"benchmarks\": [" << endl;
+	for (int i = 0; i < results.size(); i++) {
+		const BenchResult & r = results[i];
+		out << "  {\"name\": \"" << r.name << "\", \"n\": " << r.n
+			<< ", \"iterations\": " << r.iterations
+			<< ", \"ns_per_iteration\": " << r.nsPerIteration
+			<< ", \"ns_per_object\": " << r.nsPerObject << "}"
+			<< (i + 1 < results.size() ? "," : "") << endl;
+	}
+	out << "]}" << endl;
+}
+
+int runBenchmarks(const string & format, int maxN) {
+	if (format != "csv" && format != "json") {
+		LOG_ERROR("Unknown benchmark format: %s", format.c_str());
+		return 1;
+	}
+	Benchmark bench(maxN);
+	bench.runAll();
+	if (format == "json") bench.writeJson(cout);
+	else bench.writeCsv(cout);
+	return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ofMain.h"
+#include <functional>
+
+//  One timed case: "name" run over "n" objects
+//
+struct BenchResult {
+	string name;
+	int n;
+	long iterations;
+	double nsPerIteration;
+	double nsPerObject;
+};
+
+//  Microbenchmarks for the simulation hot paths, run headless from
+//  --bench.  Each case is timed at 10^2 .. maxN objects: setup() builds the
+//  data outside the timing, then body() is repeated until at least minTime
+//  seconds have passed.  Results are printed as CSV or JSON so they can be
+//  compared release over release.
+//
+class Benchmark {
+public:
+	Benchmark(int maxN = 1000000, double minTime = 0.25);
+	void run(const string & name, std::function<void(int n)> setup, std::function<void()> body);
+	void runAll();
+	void writeCsv(ostream & out) const;
+	void writeJson(ostream & out) const;
+
+	int maxN;
+	double minTime;		// sec per case
+	vector<BenchResult> results;
+};
+
+//  Returns a process exit code.  format is "csv" or "json".
+//
+int runBenchmarks(const string & format, int maxN);
@@ -0,0 +1,65 @@
+#include "Collision.h"
+
+bool sweptCircleHit(const glm::vec2 & a0, const glm::vec2 & a1,
+	const glm::vec2 & b0, const glm::vec2 & b1, float dist, float *t) {
+
+	// work in the frame of "b" so only "a" is moving.  the separation
+	// between the two is then d(s) = d0 + s * e  for s in [0, 1]
+	//
+	glm::vec2 d0 = a0 - b0;
+	glm::vec2 e = (a1 - b1) - d0;
+	float dist2 = dist * dist;
+
+	// already touching at the start of the frame
+	//
+	if (glm::dot(d0, d0) < dist2) {
+		if (t) *t = 0;
+		return true;
+	}
+
+	// no relative motion - nothing changes during the frame
+	//
+	float ee = glm::dot(e, e);
+	if (ee < 1.0e-6) return false;
+
+	// time of closest approach, clamped to this frame
+	//
+	float s = ofClamp(-glm::dot(d0, e) / ee, 0, 1);
+	glm::vec2 closest = d0 + e * s;
+	if (glm::dot(closest, closest) < dist2) {
+		if (t) *t = s;
+		return true;
+	}
+	return false;
+}
+
+CollisionFilter::CollisionFilter() {
+	for (int i = 0; i < NumCollisionLayers; i++) mask[i] = 0;
+}
+
+void CollisionQueue::add(short system, short hitBy, int index, const glm::vec2 & position) {
+	CollisionEvent e;
+	e.system = system;
+	e.hitBy = hitBy;
+	e.index = index;
+	e.position = position;
+	events.push_back(e);
+}
+
+//  Sort events by system and sprite index and drop duplicates (a sprite
+//  hit by two missiles in the same frame is only destroyed and scored once).
+//  Missile hits sort first so that, when a missile and the lander hit the
+//  same sprite, the event kept is the one the player scores for.
+//
+void CollisionQueue::sortAndMerge() {
+	std::sort(events.begin(), events.end(), [](const CollisionEvent & a, const CollisionEvent & b) {
+		if (a.system != b.system) return a.system < b.system;
+		if (a.index != b.index) return a.index < b.index;
+		bool missileA = a.hitBy == LayerMissile, missileB = b.hitBy == LayerMissile;
+		if (missileA != missileB) return missileA;
+		return a.hitBy < b.hitBy;
+	});
+	events.erase(std::unique(events.begin(), events.end(), [](const CollisionEvent & a, const CollisionEvent & b) {
+		return a.system == b.system && a.index == b.index;
+	}), events.end());
+}
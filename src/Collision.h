@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ofMain.h"
+
+//  Swept (continuous) circle test.
+//
+//  Two objects move in a straight line over the same frame, "a" from a0 to a1
+//  and "b" from b0 to b1.  Returns true if at any time during the frame they
+//  come within "dist" of each other.  Testing the whole path instead of just
+//  the end-of-frame positions means fast objects can't tunnel through each
+//  other when the frame rate drops.
+//
+//  If t is not NULL, it is set to the normalized time [0, 1] within the frame
+//  of the closest approach.
+//
+bool sweptCircleHit(const glm::vec2 & a0, const glm::vec2 & a1,
+	const glm::vec2 & b0, const glm::vec2 & b1, float dist, float *t = NULL);
+
+//  Collision layers.  Every sprite system (and the lander) belongs to one
+//  layer; a CollisionFilter decides which layers can hit which.
+//
+typedef enum { LayerShip, LayerMissile, LayerInvader, NumCollisionLayers } CollisionLayer;
+
+//  Filter matrix of which layers collide.  enable(target, source) means
+//  objects in "target" are hit by (and get events for) objects in "source".
+//  Pairs that aren't enabled are never tested.
+//
+class CollisionFilter {
+public:
+	CollisionFilter();
+	void enable(int target, int source) { mask[target] |= 1 << source; }
+	void disable(int target, int source) { mask[target] &= ~(1 << source); }
+	bool hits(int target, int source) const { return (mask[target] & (1 << source)) != 0; }
+	bool any(int target) const { return mask[target] != 0; }
+	unsigned int mask[NumCollisionLayers];
+};
+
+//  A single collision found during the collision pass.  The pass only
+//  records these; removing sprites, scoring, sound and explosions are all
+//  done afterwards in one batch (see ofApp::handleCollisions()).
+//
+struct CollisionEvent {
+	short system;		// index of the sprite system that was hit
+	short hitBy;		// CollisionLayer of what hit it
+	int index;			// index of the sprite within that system
+	glm::vec2 position;	// where the sprite was when it was hit
+};
+
+//  Per-frame queue of collision events.  Cleared at the start of every
+//  collision pass; storage is kept between frames so it doesn't reallocate.
+//
+class CollisionQueue {
+public:
+	void add(short system, short hitBy, int index, const glm::vec2 & position);
+	void clear() { events.clear(); }
+	void sortAndMerge();
+	vector<CollisionEvent> events;
+};
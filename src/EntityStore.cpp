@@ -0,0 +1,189 @@
+#include "EntityStore.h"
+#include "RenderQueue.h"
+
+//  Add an entity with default components, return its index
+//
+int EntityStore::create() {
+	position.push_back(glm::vec3(0, 0, 0));
+	lastPosition.push_back(glm::vec3(0, 0, 0));
+	velocity.push_back(glm::vec3(0, 0, 0));
+	acceleration.push_back(glm::vec3(0, 0, 0));
+	forces.push_back(glm::vec3(0, 0, 0));
+	mass.push_back(1);
+	damping.push_back(1);
+	birthtime.push_back(0);
+	lifespan.push_back(-1);
+	image.push_back(NULL);
+	dimensions.push_back(glm::vec2(20, 20));
+	radius.push_back(0);
+	color.push_back(ofColor::white);
+	created++;
+	return position.size() - 1;
+}
+
+//  Remove entity i by moving the last entity into its place
+//
+void EntityStore::remove(int i) {
+	int last = position.size() - 1;
+	if (i != last) {
+		position[i] = position[last];
+		lastPosition[i] = lastPosition[last];
+		velocity[i] = velocity[last];
+		acceleration[i] = acceleration[last];
+		forces[i] = forces[last];
+		mass[i] = mass[last];
+		damping[i] = damping[last];
+		birthtime[i] = birthtime[last];
+		lifespan[i] = lifespan[last];
+		image[i] = image[last];
+		dimensions[i] = dimensions[last];
+		radius[i] = radius[last];
+		color[i] = color[last];
+	}
+	position.pop_back();
+	lastPosition.pop_back();
+	velocity.pop_back();
+	acceleration.pop_back();
+	forces.pop_back();
+	mass.pop_back();
+	damping.pop_back();
+	birthtime.pop_back();
+	lifespan.pop_back();
+	image.pop_back();
+	dimensions.pop_back();
+	radius.pop_back();
+	color.pop_back();
+}
+
+//  Remove several entities given their indices sorted ascending.  Removing
+//  from the back keeps the remaining indices valid.
+//
+void EntityStore::removeSorted(const vector<int> & indices) {
+	for (int i = indices.size() - 1; i >= 0; i--) {
+		remove(indices[i]);
+	}
+}
+
+void EntityStore::clear() {
+	position.clear();
+	lastPosition.clear();
+	velocity.clear();
+	acceleration.clear();
+	forces.clear();
+	mass.clear();
+	damping.clear();
+	birthtime.clear();
+	lifespan.clear();
+	image.clear();
+	dimensions.clear();
+	radius.clear();
+	color.clear();
+}
+
+void EntityStore::reserve(int n) {
+	position.reserve(n);
+	lastPosition.reserve(n);
+	velocity.reserve(n);
+	acceleration.reserve(n);
+	forces.reserve(n);
+	mass.reserve(n);
+	damping.reserve(n);
+	birthtime.reserve(n);
+	lifespan.reserve(n);
+	image.reserve(n);
+	dimensions.reserve(n);
+	radius.reserve(n);
+	color.reserve(n);
+}
+
+//  Lifetime system - remove every entity that has exceeded its lifespan.
+//  Returns the number removed.
+//
+int expireEntities(EntityStore & store, float now) {
+	int count = 0;
+	int i = 0;
+	while (i < store.size()) {
+		if (store.lifespan[i] != -1 && now - store.birthtime[i] > store.lifespan[i]) {
+			store.remove(i);	// the last entity moves into i, so check i again
+			count++;
+		}
+		else i++;
+	}
+	store.expired += count;
+	return count;
+}
+
+//  Motion system - integrate every entity over the time step dt (sec).
+//
+void integrateEntities(EntityStore & store, float dt) {
+	int n = store.size();
+	for (int i = 0; i < n; i++) {
+
+		// remember where we started for swept collision tests
+		//
+		store.lastPosition[i] = store.position[i];
+
+		// update position based on velocity
+		//
+		store.position[i] += store.velocity[i] * dt;
+
+		// update velocity from acceleration plus accumulated forces
+		// (a = 1/m * f), then add a little damping
+		//
+		glm::vec3 accel = store.acceleration[i] + store.forces[i] * (1.0f / store.mass[i]);
+		store.velocity[i] += accel * dt;
+		store.velocity[i] *= store.damping[i];
+
+		// clear forces (they get re-added each step)
+		//
+		store.forces[i] = glm::vec3(0, 0, 0);
+	}
+}
+
+//  As drawEntities(), recorded into a render queue
+//
+void queueEntities(RenderQueue & queue, const EntityStore & store, float now) {
+	int n = store.size();
+	for (int i = 0; i < n; i++) {
+		const glm::vec3 & p = store.position[i];
+		const glm::vec2 & s = store.dimensions[i];
+		if (store.image[i]) {
+			queue.setColor(ofColor(255, 255, 255, 255));
+			queue.image(*store.image[i], -s.x / 2.0 + p.x, -s.y / 2.0 + p.y);
+		}
+		else if (store.radius[i] > 0) {
+			float age = now - store.birthtime[i];
+			queue.setColor(ofColor(ofMap(age, 0, store.lifespan[i], 255, 10), 0, 0));
+			queue.sphere(p, store.radius[i]);
+		}
+		else {
+			queue.setColor(ofColor(255, 0, 0));
+			queue.rect(-s.x / 2.0 + p.x, -s.y / 2.0 + p.y, s.x, s.y);
+		}
+	}
+}
+
+//  Render system - images are drawn centered on the entity, entities with
+//  a radius and no image are drawn as spheres that fade with age, anything
+//  else as a box.
+//
+void drawEntities(const EntityStore & store, float now) {
+	int n = store.size();
+	for (int i = 0; i < n; i++) {
+		const glm::vec3 & p = store.position[i];
+		const glm::vec2 & s = store.dimensions[i];
+		if (store.image[i]) {
+			ofSetColor(255, 255, 255, 255);
+			store.image[i]->draw(-s.x / 2.0 + p.x, -s.y / 2.0 + p.y);
+		}
+		else if (store.radius[i] > 0) {
+			float age = now - store.birthtime[i];
+			ofSetColor(ofMap(age, 0, store.lifespan[i], 255, 10), 0, 0);
+			ofDrawSphere(p, store.radius[i]);
+		}
+		else {
+			ofSetColor(255, 0, 0);
+			ofDrawRectangle(-s.x / 2.0 + p.x, -s.y / 2.0 + p.y, s.x, s.y);
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ofMain.h"
+
+class RenderQueue;
+
+//  Dense component store shared by particles and sprites.
+//
+//  Every component is its own array and entity i's data lives at index i of
+//  each one, so a pass only touches the arrays it needs (motion doesn't pull
+//  images or colors into cache, drawing doesn't pull forces).  Removing an
+//  entity moves the last one into its slot, so the arrays never have holes.
+//  Note that this means removal does not preserve order.
+//
+//  Times are in milliseconds.  A lifespan of -1 means immortal.
+//
+class EntityStore {
+public:
+	int  create();
+	void remove(int i);
+	void removeSorted(const vector<int> & indices);
+	void clear();
+	void reserve(int n);
+	int  size() const { return position.size(); }
+
+	// motion
+	//
+	vector<glm::vec3> position;
+	vector<glm::vec3> lastPosition;		// position at the start of the frame
+	vector<glm::vec3> velocity;			// pixels/sec
+	vector<glm::vec3> acceleration;
+	vector<glm::vec3> forces;			// accumulated each frame, cleared by integrate
+	vector<float> mass;
+	vector<float> damping;
+
+	// lifetime
+	//
+	vector<float> birthtime;
+	vector<float> lifespan;
+
+	// rendering
+	//
+	vector<const ofImage *> image;		// NULL => draw a sphere (radius > 0) or a box
+	vector<glm::vec2> dimensions;		// width, height of the image/box
+	vector<float> radius;
+	vector<ofColor> color;
+
+	// running totals for telemetry
+	//
+	unsigned long created = 0;
+	unsigned long expired = 0;
+};
+
+//  Systems - each is a single linear pass over one store, and the same code
+//  runs for every kind of object.
+//
+int  expireEntities(EntityStore & store, float now);
+void integrateEntities(EntityStore & store, float dt);
+void drawEntities(const EntityStore & store, float now);
+void queueEntities(RenderQueue & queue, const EntityStore & store, float now);
@@ -0,0 +1,452 @@
+#include "GameWorld.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "ThreadPool.h"
+
+GameWorld::GameWorld() {
+	fireRate = 10;
+	laserLife = 2.5;
+	laserVelocity = ofVec3f(0, -500, 0);
+	explosionVelocity = ofVec3f(100, 100, 0);
+	roundLength = 30;
+	width = 0;
+	height = 0;
+	turret = NULL;
+	pool = NULL;
+	seed = 1;
+	stepDt = 0;
+	turbForce = NULL;
+	gravityForce = NULL;
+	radialForce = NULL;
+	score = 0;
+	idle = true;
+	gameOver = false;
+	ticks = 0;
+	collisionCount = 0;
+	shotSounds = 0;
+	explosionSounds = 0;
+	time = 0;
+	roundStart = 0;
+}
+
+GameWorld::~GameWorld() {
+	for (int i = 0; i < invaders.size(); i++) {
+		delete invaders[i]->sys;
+		delete invaders[i];
+	}
+	if (turret) {
+		delete turret->sys;
+		delete turret;
+	}
+	delete turbForce;
+	delete gravityForce;
+	delete radialForce;
+	delete pool;
+}
+
+//  where the lander starts each round
+//
+glm::vec3 GameWorld::shipStart() const {
+	return glm::vec3(width / 2.0, height - 400 / 2.0, 0);
+}
+
+//  Create the emitters for a playfield of the given size.  Sprites are
+//  drawn as boxes and sized by the default image sizes until setImages()
+//  is called.
+//
+void GameWorld::setup(int w, int h) {
+	width = w;
+	height = h;
+
+	ship.setPosition(shipStart());
+
+	turret = new Emitter(new SpriteSystem());
+	turret->setPosition(ship.getPosition());
+	turret->setChildSize(50, 50);
+
+	float x[] = { width / 2.0f, width / 4.0f, width * 0.75f, width * 0.65f };
+	for (int i = 0; i < 4; i++) {
+		Emitter *invader = new Emitter(new SpriteSystem());
+		invader->setChildSize(90, 140);
+		invader->setPosition(ofVec3f(x[i], 10, 0));
+		invader->velocity.set(0, 400, 0);
+		invader->setLifespan(3000);
+		invader->setRate(0.5);
+		invaders.push_back(invader);
+	}
+	invaders[1]->velocity.set(ship.getPosition() * ship.heading());
+
+	// set up the explosion forces
+	//
+	turbForce = new TurbulenceForce(ofVec3f(-20, -20, -20), ofVec3f(20, 20, 20));
+	gravityForce = new GravityForce(ofVec3f(0, -10, 0));
+	radialForce = new ImpulseRadialForce(1000.0);
+
+	explosions.addForce(turbForce);
+	explosions.addForce(gravityForce);
+	explosions.addForce(radialForce);
+
+	for (int i = 0; i < invaders.size(); i++) {
+		ParticleEmitter &emitter = invaders[i]->sys->emitter;
+		emitter.setSystem(&explosions);
+		emitter.setVelocity(explosionVelocity);
+		emitter.setOneShot(true);
+		emitter.setEmitterType(RadialEmitter);
+		emitter.setGroupSize(50);
+	}
+
+	// collision layers: invaders are destroyed by missiles (scoring) and by
+	// running into the lander.  Missiles and the lander are never hit.
+	//
+	addCollider(turret->sys, LayerMissile, turret->childHeight / 2);
+	for (int i = 0; i < invaders.size(); i++) {
+		addCollider(invaders[i]->sys, LayerInvader, invaders[i]->childHeight / 2);
+	}
+	collisionFilter.enable(LayerInvader, LayerMissile);
+	collisionFilter.enable(LayerInvader, LayerShip);
+
+	// room for a busy step's hits up front, so the first one doesn't
+	// allocate mid game
+	//
+	collisions.events.reserve(256);
+	removeList.reserve(256);
+
+	invaderRandom.resize(invaders.size());
+	setSeed(seed);
+	buildSystems();
+}
+
+//  Give the sprites images to draw.  The images must outlive the world.
+//  Collision radii follow the image sizes.
+//
+void GameWorld::setImages(const ofImage & shipImage, const ofImage & laser, const ofImage & invader) {
+	ship.spriteImage = shipImage;
+	turret->setChildImage(laser);
+	for (int i = 0; i < invaders.size(); i++) {
+		invaders[i]->setChildImage(invader);
+	}
+	turret->sys->radius = turret->childHeight / 2;
+	for (int i = 0; i < invaders.size(); i++) {
+		invaders[i]->sys->radius = invaders[i]->childHeight / 2;
+	}
+}
+
+//  Advance the world by dt seconds
+//
+void GameWorld::step(float dt) {
+	PROFILE_SCOPE("step");
+	scratch.reset();
+	time += dt * 1000;
+	ticks++;
+	stepDt = dt;
+
+	systems.run(pool);
+
+	if (!idle && roundTime() >= roundLength) endRound();
+}
+
+//  The systems run by step(), in the order they would run serially, with
+//  the state each one reads and writes.  The turret and each invader
+//  emitter only touch their own sprites (each invader has its own random
+//  stream for that), so they can run at the same time, as can the lander
+//  once the turret has read its position.  Collisions need everything to
+//  have moved, and they and the explosion emitters all restart or add to
+//  the one explosion particle system, so those run one after another.
+//
+void GameWorld::buildSystems() {
+	systems.clear();
+	int shipState = systems.resource("ship");
+	int lasers = systems.resource("lasers");
+	int score = systems.resource("score");
+	int particles = systems.resource("explosions");
+	vector<int> invaderState;
+	for (int i = 0; i < invaders.size(); i++) {
+		invaderState.push_back(systems.resource("invader " + ofToString(i)));
+	}
+
+	systems.add("turret", [this]() {
+		ALLOC_TAG("turret");
+		turret->setRate(fireRate);
+		turret->setLifespan(laserLife * 1000);    // convert to milliseconds 
+		turret->setVelocity(ship.heading() * -laserVelocity.y);
+		turret->update(time, stepDt);
+		turret->setPosition(glm::vec3(ship.getPosition().x, ship.getPosition().y, 0));
+	}, { shipState }, { lasers });
+
+	for (int i = 0; i < invaders.size(); i++) {
+		systems.add("invader launch " + ofToString(i), [this, i]() {
+			ALLOC_TAG("invaders");
+			invaders[i]->launch(time, stepDt, invaderRandom[i]);
+		}, {}, { invaderState[i] });
+	}
+
+	systems.add("ship", [this]() {
+		moveShip(stepDt);
+	}, {}, { shipState });
+
+	vector<int> collided = invaderState;
+	collided.push_back(lasers);
+	collided.push_back(score);
+	collided.push_back(particles);		// handleCollisions() resets the explosions
+	systems.add("collisions", [this]() {
+		ALLOC_TAG("collisions");
+		checkCollisions();
+		handleCollisions();
+	}, { shipState }, collided);
+
+	for (int i = 0; i < invaders.size(); i++) {
+		systems.add("explosion emitter " + ofToString(i), [this, i]() {
+			ALLOC_TAG("explosions");
+			invaders[i]->sys->emitter.update(time, stepDt, random);
+		}, {}, { invaderState[i], particles });
+	}
+
+	systems.add("explosion particles", [this]() {
+		ALLOC_TAG("explosions");
+		explosions.update(time, stepDt, random);
+	}, {}, { particles });
+}
+
+//  Keep the lander on the playfield and move it
+//
+void GameWorld::moveShip(float dt) {
+	glm::vec3 shipPos = ship.getPosition();
+	bool clamped = false;
+	if (shipPos.x < 20 ) {
+		shipPos.x = 25;
+		clamped = true;
+	}
+	if (shipPos.x > width - 20) {
+		shipPos.x = width - 25;
+		clamped = true;
+	}
+	if (shipPos.y < 20) {
+		shipPos.y = 30;
+		clamped = true;
+	}
+	if (shipPos.y > height - 20) {
+		shipPos.y = height - 25;
+		clamped = true;
+	}
+	if (clamped) {
+		ship.setPosition(shipPos);
+		ship.thrust = ofVec3f(0, 0, 0);
+	}
+	
+	ship.integrate(dt); 
+	ship.updateEdges();
+}
+
+//  Run the systems on n worker threads (plus the stepping thread), or all
+//  on the stepping thread if n is 0
+//
+void GameWorld::setThreads(int n) {
+	delete pool;
+	pool = n > 0 ? new ThreadPool(n) : NULL;
+}
+
+//  Seed the world's random streams: one for the explosions and one for each
+//  invader emitter, so the emitters can launch in parallel and still give
+//  the same results for the same seed
+//
+void GameWorld::setSeed(uint64_t seed) {
+	this->seed = seed;
+	random.setSeed(Random::stream(seed, 0));
+	for (int i = 0; i < invaderRandom.size(); i++) invaderRandom[i].setSeed(Random::stream(seed, 1 + i));
+}
+
+//  Start a round (space while idle)
+//
+void GameWorld::startRound() {
+	turret->start(time);
+	for (int i = 0; i < invaders.size(); i++) {
+		invaders[i]->start(time);
+	}
+	idle = false;
+	gameOver = false;
+	roundStart = time;
+}
+
+//  The round's time is up - reset the lander and clear the invaders
+//
+void GameWorld::endRound() {
+	gameOver = true;
+	idle = true;
+	ship.thrust = ofVec3f(0, 0, 0);
+	ship.setRotation(0);
+	ship.setPosition(shipStart());
+	for (int i = 0; i < invaders.size(); i++) {
+		invaders[i]->stop();
+		invaders[i]->sys->clear();
+	}
+}
+
+//  Register a sprite system for collision tests
+//
+void GameWorld::addCollider(SpriteSystem *sys, CollisionLayer layer, float radius) {
+	sys->layer = layer;
+	sys->radius = radius;
+	colliders.push_back(sys);
+}
+
+//  This is a simple O(M x N) collision check
+//  For every pair of collider systems whose layers are enabled in the
+//  collision filter (e.g. invaders hit by missiles), check each sprite of the
+//  "source" system against the "target" system.  Pairs that aren't enabled
+//  are skipped entirely.
+//
+//  Missiles and invaders both travel 500-1000 pixels/sec, which can be more
+//  than the collision distance per frame when the frame rate drops, so each
+//  sprite is tested along the path it travelled this frame (see findSwept())
+//  rather than just at its end-of-frame position.
+//
+//  The pass itself has no side effects; it only fills the "collisions"
+//  queue, which handleCollisions() consumes afterwards.
+//
+void GameWorld::checkCollisions() {
+	collisions.clear();
+
+	for (int t = 0; t < colliders.size(); t++) {
+		SpriteSystem *target = colliders[t];
+		if (target->size() == 0 || !collisionFilter.any(target->layer)) continue;
+
+		// the lander isn't a sprite system, it has its own batched test
+		//
+		if (collisionFilter.hits(target->layer, LayerShip))
+			checkShipCollisions(t);
+
+		for (int s = 0; s < colliders.size(); s++) {
+			SpriteSystem *source = colliders[s];
+			if (s == t || !collisionFilter.hits(target->layer, source->layer)) continue;
+
+			// two sprites collide when they are within the sum of their radii
+			//
+			float dist = source->radius + target->radius;
+			const EntityStore &sprites = source->sprites;
+			for (int i = 0; i < sprites.size(); i++) {
+				target->findSwept(sprites.lastPosition[i], sprites.position[i], dist, t, source->layer, collisions);
+			}
+		}
+	}
+}
+
+//  Test every sprite in a collider system against the lander in one batch
+//  and queue the ones inside it.
+//
+void GameWorld::checkShipCollisions(short system) {
+	SpriteSystem *sys = colliders[system];
+	int n = sys->size();
+	if (n == 0) return;
+
+	float *hitX = (float *)scratch.alloc(n * sizeof(float));
+	float *hitY = (float *)scratch.alloc(n * sizeof(float));
+	unsigned char *hits = (unsigned char *)scratch.alloc(n);
+	for (int i = 0; i < n; i++) {
+		hitX[i] = sys->sprites.position[i].x;
+		hitY[i] = sys->sprites.position[i].y;
+	}
+	if (ship.insideBatch(hitX, hitY, n, hits) == 0) return;
+
+	for (int i = 0; i < n; i++) {
+		if (hits[i]) collisions.add(system, LayerShip, i, sys->sprites.position[i]);
+	}
+}
+
+//  Apply this step's collisions: remove the sprites that were hit, add up
+//  the score, and start at most one explosion per collider system and one
+//  explosion sound no matter how many invaders died this step.
+//
+void GameWorld::handleCollisions() {
+	if (collisions.events.empty()) return;
+	collisions.sortAndMerge();
+	collisionCount += collisions.events.size();
+
+	int i = 0;
+	while (i < collisions.events.size()) {
+		short system = collisions.events[i].system;
+		SpriteSystem *sys = colliders[system];
+		removeList.clear();
+
+		for (; i < collisions.events.size() && collisions.events[i].system == system; i++) {
+			const CollisionEvent &e = collisions.events[i];
+			removeList.push_back(e.index);
+			if (e.hitBy == LayerMissile) score++;
+		}
+
+		// the system has one explosion emitter, so only the last kill
+		// gets an explosion
+		//
+		const CollisionEvent &last = collisions.events[i - 1];
+		sys->emitter.setPosition(ofVec3f(last.position.x, last.position.y, 0));
+		sys->emitter.sys->reset();
+		sys->emitter.start(time);
+
+		sys->removeSorted(removeList);
+	}
+	explosionSounds++;
+	collisions.clear();
+}
+
+//  Game keys.  Space starts a round when idle, otherwise fires.
+//
+void GameWorld::keyPressed(int key) {
+	if (idle) {
+		if (key == ' ') startRound();
+		return;
+	}
+
+	switch (key) {
+	case ' ':
+		if (turret->shoot(time)) shotSounds++;
+		break;
+	case OF_KEY_UP:
+		ship.thrust += .5;
+		break;
+	case OF_KEY_DOWN:
+		ship.thrust -= .5;
+		break;
+	case OF_KEY_LEFT:
+		ship.setRotation(ship.getRotation() - 20);
+		break;
+	case OF_KEY_RIGHT:
+		ship.setRotation(ship.getRotation() + 20);
+		break;
+	}
+}
+
+void GameWorld::keyReleased(int key) {
+	switch (key) {
+	case OF_KEY_UP:     // go forward
+		if (ship.thrust.length() > 0) {
+			ship.thrust -= 1;
+		}
+		break;
+	case OF_KEY_DOWN:   // go backward
+		if (ship.thrust.length() < 0) {
+			ship.thrust += 1;
+		}
+		break;
+	}
+}
+
+//  The lander can be dragged with the mouse
+//
+void GameWorld::mousePressed(int x, int y) {
+	if (ship.inside(glm::vec3(x, y, 0)) == true) {
+		draggable = true;					// indicate that the triangle can be dragged
+		mouseLast = glm::vec3(x, y, 0);		// set the last position of the mouse
+	}
+}
+
+void GameWorld::mouseDragged(int x, int y) {
+	if (draggable) {										// if the triangle can be dragged
+		glm::vec3 mousePoint = glm::vec3(x, y, 0);			// get the coordinates of the mouse point
+		glm::vec3 difference = mousePoint - mouseLast;		// calculate the difference between the current location and the previous location of the mouse
+		ship.setPosition(ship.getPosition() + difference);	// add the difference to the triangle's position
+		mouseLast = mousePoint;								// update the last position of the mouse
+	}
+}
+
+void GameWorld::mouseReleased() {
+	draggable = false;		// disable dragging of the triangle once the mouse is released
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ofMain.h"
+#include "Shape.h"
+#include "Sprite.h"
+#include "ParticleSystem.h"
+#include "Collision.h"
+#include "Random.h"
+#include "Arena.h"
+#include "TaskGraph.h"
+
+class ThreadPool;
+
+//  The game simulation: the lander, the turret and invader emitters, the
+//  explosion particles, collisions, scoring and the timed round.
+//
+//  A GameWorld does not need a window, GL context, fonts or sound, so it can
+//  be stepped headless as fast as the CPU allows.  It keeps its own clock
+//  (advanced only by step()) instead of reading the wall clock, and its own
+//  random number generator instead of ofRandom(), so worlds are fully
+//  independent of each other and can be stepped on different threads.  Rendering
+//  and audio are left to the app: it draws the world's objects and plays
+//  sounds for the counts in shotSounds/explosionSounds.
+//
+class GameWorld {
+public:
+	GameWorld();
+	~GameWorld();
+	GameWorld(const GameWorld &) = delete;
+	GameWorld & operator=(const GameWorld &) = delete;
+	void setup(int width, int height);
+	void setSeed(uint64_t seed);
+	void setThreads(int n);
+	void setImages(const ofImage & ship, const ofImage & laser, const ofImage & invader);
+	void step(float dt);		// advance the simulation dt seconds
+
+	// input
+	//
+	void keyPressed(int key);
+	void keyReleased(int key);
+	void mousePressed(int x, int y);
+	void mouseDragged(int x, int y);
+	void mouseReleased();
+
+	void startRound();
+	void endRound();
+	float getTime() const { return time; }				// ms since setup
+	float roundTime() const { return (time - roundStart) / 1000.0; }	// sec
+
+	void moveShip(float dt);
+	void checkCollisions();
+	void addCollider(SpriteSystem *sys, CollisionLayer layer, float radius);
+	void checkShipCollisions(short system);
+	void handleCollisions();
+
+	// settings (the app copies these from its GUI)
+	//
+	float fireRate;				// shots/sec
+	float laserLife;			// sec
+	ofVec3f laserVelocity;		// pixels/sec, only y is used (along the heading)
+	ofVec3f explosionVelocity;
+	float roundLength;			// sec
+
+	int width, height;			// size of the playfield
+	Random random;				// explosions
+	vector<Random> invaderRandom;	// one per invader emitter
+
+	TriangleShape ship = TriangleShape(glm::vec3(-20, 20, 0), glm::vec3(0, -40, 0), glm::vec3(20, 20, 0));
+	Emitter *turret;
+	vector<Emitter *> invaders;
+
+	// one particle system shared by all the explosion emitters
+	//
+	ParticleSystem explosions;
+	TurbulenceForce *turbForce;
+	GravityForce *gravityForce;
+	ImpulseRadialForce *radialForce;
+
+	int score;
+	bool idle;					// waiting for space to start a round
+	bool gameOver;				// set when a round ends, cleared on start
+	unsigned long ticks;		// steps taken since setup
+	unsigned long collisionCount;	// collision events handled since setup
+
+	// sounds the app should play, accumulated until it clears them
+	//
+	int shotSounds;
+	int explosionSounds;
+
+	bool draggable = false;		// indicates that the triangle can be dragged
+	glm::vec3 mouseLast;		// the last position of the mouse 
+
+	// sprite systems taking part in collisions and which of their layers
+	// collide, the collisions found this step, and the sprite indices to
+	// remove for each system while handling them
+	//
+	vector<SpriteSystem *> colliders;
+	CollisionFilter collisionFilter;
+	CollisionQueue collisions;
+	vector<int> removeList;
+
+	// memory for data that only lives for one step (reset at its start)
+	//
+	Arena scratch;
+
+	// the systems step() runs and the threads it runs them on (NULL =>
+	// serially on the calling thread)
+	//
+	TaskGraph systems;
+	ThreadPool *pool;
+
+private:
+	float time;
+	float roundStart;
+	float stepDt;				// dt of the step in progress, for the systems
+	uint64_t seed;
+	void buildSystems();
+	glm::vec3 shipStart() const;
+};
@@ -0,0 +1,237 @@
+#include "Headless.h"
+#include "GameWorld.h"
+#include "InputLog.h"
+#include "Log.h"
+#include "AllocTracker.h"
+#include "RenderSnapshot.h"
+#include "Scene.h"
+#include "SoftRenderBackend.h"
+#include <chrono>
+
+void scriptInput(GameWorld & world, long tick, InputLog *log) {
+	int key = ' ';
+	if (log) log->record(InputKeyPressed, world.ticks, key);
+	world.keyPressed(key);
+	if (tick % 60 == 0) {
+		key = (tick / 60) % 4 < 2 ? OF_KEY_LEFT : OF_KEY_RIGHT;
+		if (log) log->record(InputKeyPressed, world.ticks, key);
+		world.keyPressed(key);
+	}
+}
+
+int runHeadless(long ticks, const string & recordPath, double maxAllocs) {
+	const float tickLength = 1.0 / 60;
+
+	GameWorld world;
+	InputLog log;
+	log.begin(world, 1, 750, 1334);
+	InputLog *record = recordPath != "" ? &log : NULL;
+
+	int rounds = 0;
+	long totalScore = 0;
+	int bestScore = 0;
+
+	// heap allocations are counted after the first tenth of the run, once
+	// the buffers have grown to their steady state sizes
+	//
+	long warmup = ticks / 10;
+	AllocSnapshot allocStart;
+
+	auto start = std::chrono::steady_clock::now();
+	for (long i = 0; i < ticks; i++) {
+		if (i == warmup) allocSnapshot(allocStart);
+		scriptInput(world, i, record);
+		if (record) record->recordSettings(world);
+
+		bool wasIdle = world.idle;
+		world.step(tickLength);
+		world.shotSounds = 0;
+		world.explosionSounds = 0;
+
+		if (!wasIdle && world.idle) {
+			int roundScore = world.score;
+			rounds++;
+			totalScore += roundScore;
+			if (roundScore > bestScore) bestScore = roundScore;
+			world.score = 0;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	double secs = std::chrono::duration<double>(end - start).count();
+	AllocSnapshot allocEnd;
+	allocSnapshot(allocEnd);
+
+	if (record) {
+		log.end(world);
+		if (!log.save(recordPath)) {
+			LOG_ERROR("Can't save input log: %s", recordPath.c_str());
+			return 1;
+		}
+	}
+
+	cout << "headless: " << ticks << " ticks in " << secs << " sec ("
+		<< (secs > 0 ? ticks / secs : 0) << " ticks/sec, "
+		<< (secs > 0 ? ticks * tickLength / secs : 0) << "x real time)" << endl;
+	cout << "headless: " << rounds << " rounds, mean score "
+		<< (rounds > 0 ? (double)totalScore / rounds : 0) << ", best " << bestScore << endl;
+
+	if (allocTrackingEnabled() && ticks > warmup) {
+		AllocSnapshot a = allocDelta(allocStart, allocEnd);
+		long measured = ticks - warmup;
+		cout << "allocs: " << (double)allocTotal(a) / measured << " per tick after "
+			<< warmup << " ticks warm up, peak " << a.peak << " bytes" << endl;
+		for (int i = 0; i < a.tags; i++) {
+			if (a.allocs[i] == 0) continue;
+			cout << "allocs: " << allocTagName(i) << " " << (double)a.allocs[i] / measured
+				<< " per tick, " << (double)a.bytes[i] / measured << " bytes per tick" << endl;
+		}
+		double perTick = (double)allocTotal(a) / measured;
+		if (perTick > maxAllocs) {
+			LOG_ERROR("%g allocs per tick after warm up, more than the %g allowed", perTick, maxAllocs);
+			return 2;
+		}
+	}
+	return 0;
+}
+
+//  Images for a headless run, kept on the CPU
+//
+static bool loadImage(ofImage & image, const string & path) {
+	image.setUseTexture(false);
+	if (image.load(path)) return true;
+	LOG_WARNING("Can't load image: %s", path.c_str());
+	return false;
+}
+
+int runRender(long frames, const string & framePath) {
+	const float tickLength = 1.0 / 60;
+	const int width = 750, height = 1334;
+
+	GameWorld world;
+	InputLog log;
+	log.begin(world, 1, width, height);
+
+	ofImage ship, background, laser, invader;
+	ofImage *image[] = { &ship, &background, &laser, &invader };
+	const char *path[] = { "images/ship.png", "images/background.png", "images/laser.png", "images/invader.png" };
+	int loaded = 0;
+	for (int i = 0; i < 4; i++) {
+		if (loadImage(*image[i], path[i])) loaded++;
+	}
+	bool images = loaded == 4;
+	if (images) world.setImages(ship, laser, invader);
+
+	Scene scene;
+	scene.resize(width, height);
+	scene.background = images ? &background : NULL;
+	scene.ship = images ? &ship : NULL;
+	scene.drawHeading = true;
+	scene.drawPaths = true;
+
+	RenderSnapshot snapshot;
+	RenderQueue queue;
+	SoftRenderBackend frame(width, height);
+
+	double recordTime = 0, sortTime = 0, rasterTime = 0;
+	double commands = 0, batches = 0, stateChanges = 0;
+
+	// each change to a line of the HUD's text, to check the rebuilds by
+	//
+	unsigned long rebuildsBefore = TextMesh::rebuilds;
+	long textChanges = 0;
+	int lastScore = -1, lastTime = -1;
+	bool prompted = false, over = false;
+
+	for (long i = 0; i < frames; i++) {
+		scriptInput(world, i);
+		world.step(tickLength);
+		world.shotSounds = 0;
+		world.explosionSounds = 0;
+		snapshot.capture(world);
+
+		if (snapshot.idle) {
+			if (!prompted) textChanges++;
+			prompted = true;
+		}
+		else {
+			if (snapshot.score != lastScore) textChanges++;
+			if ((int)snapshot.roundTime != lastTime) textChanges++;
+			lastScore = snapshot.score;
+			lastTime = (int)snapshot.roundTime;
+		}
+		if (snapshot.gameOver && !over) textChanges++;
+		over = over || snapshot.gameOver;
+
+		auto t0 = std::chrono::steady_clock::now();
+		queue.clear();
+		scene.record(queue, snapshot);
+		auto t1 = std::chrono::steady_clock::now();
+		queue.sort();
+		auto t2 = std::chrono::steady_clock::now();
+		frame.clear(ofColor::black);
+		queue.submit(frame);
+		auto t3 = std::chrono::steady_clock::now();
+
+		recordTime += std::chrono::duration<double>(t1 - t0).count();
+		sortTime += std::chrono::duration<double>(t2 - t1).count();
+		rasterTime += std::chrono::duration<double>(t3 - t2).count();
+		commands += queue.sorted.commands;
+		batches += queue.sorted.batches;
+		stateChanges += queue.sorted.stateChanges();
+	}
+
+	double n = max(frames, 1L);
+	cout << "render: " << frames << " frames at " << width << "x" << height << ", ms per frame: record "
+		<< recordTime * 1000 / n << ", sort " << sortTime * 1000 / n << ", raster " << rasterTime * 1000 / n << endl;
+	cout << "render: per frame " << commands / n << " commands, " << batches / n << " batches, "
+		<< stateChanges / n << " state changes" << endl;
+	cout << "render: last frame checksum " << hex << frame.checksum() << dec << endl;
+
+	long rebuilds = TextMesh::rebuilds - rebuildsBefore;
+	cout << "render: " << rebuilds << " text mesh rebuilds for " << textChanges << " changes to the text" << endl;
+
+	if (framePath != "" && !frame.save(framePath)) {
+		LOG_ERROR("Can't save frame: %s", framePath.c_str());
+		return 1;
+	}
+	if (rebuilds > textChanges) {
+		LOG_ERROR("%ld text mesh rebuilds, more than the %ld changes to the text", rebuilds, textChanges);
+		return 2;
+	}
+	return 0;
+}
+
+int runReplay(const string & path) {
+	InputLog log;
+	if (!log.load(path)) {
+		LOG_ERROR("Can't load input log: %s", path.c_str());
+		return 1;
+	}
+
+	GameWorld world;
+	log.setup(world);
+
+	auto start = std::chrono::steady_clock::now();
+	while (!log.finished(world)) {
+		log.apply(world);
+		world.step(log.tickLength);
+		world.shotSounds = 0;
+		world.explosionSounds = 0;
+	}
+	auto end = std::chrono::steady_clock::now();
+	double secs = std::chrono::duration<double>(end - start).count();
+
+	// fold the final state into a checksum; two replays of the same log
+	// must agree
+	//
+	glm::vec3 p = world.ship.getPosition();
+	uint64_t sum = world.ticks * 31 + world.score;
+	sum = sum * 31 + (int64_t)(p.x * 1000);
+	sum = sum * 31 + (int64_t)(p.y * 1000);
+	sum = sum * 31 + world.random.next();
+
+	cout << "replay: " << world.ticks << " ticks, " << log.events.size() << " events in "
+		<< secs << " sec (" << (secs > 0 ? world.ticks / secs : 0) << " ticks/sec)" << endl;
+	cout << "replay: score " << world.score << ", checksum " << hex << sum << dec << endl;
+	return 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+using std::string;
+
+class GameWorld;
+
+//  Scripted input for runs without a player: start a round when idle, fire
+//  every tick (the turret's rate limits the actual shots) and sweep the
+//  lander left and right once a second.  tick is the world's tick count.
+//  The input is also added to log if one is given.
+//
+class InputLog;
+void scriptInput(GameWorld & world, long tick, InputLog *log = NULL);
+
+//  Run the simulation with no window, GL context or sound, as fast as the
+//  CPU allows, for the given number of fixed ticks with scripted input.
+//  Prints ticks/second and round results.
+//
+//  If recordPath is given the scripted session is saved there for --replay.
+//
+//  In LANDER_TRACK_ALLOCS builds the heap allocations per tick after warm
+//  up are checked against maxAllocs: more than that is a regression, and
+//  the run fails (exit code 2) so scripts and CI can catch it.
+//
+//  Returns a process exit code.
+//
+int runHeadless(long ticks, const string & recordPath = "", double maxAllocs = 0);
+
+//  Run the simulation as runHeadless() does and draw every tick into
+//  memory with the software rasterizer, through the same scene recording
+//  and render queue as the window, so the cost of drawing can be measured
+//  without a GPU.  Images are loaded from data/images if they're there;
+//  there's no text, which needs fonts (and so GL).  Both debug overlays
+//  are on, so every kind of draw is exercised.
+//
+//  Prints the time per frame spent recording, sorting and rasterizing,
+//  the queue's stats, and a checksum of the last frame, which is also
+//  saved to framePath (a PPM) if one is given: a golden frame to compare
+//  builds against.
+//
+//  The HUD's text meshes are counted as they would be rebuilt (there are
+//  no fonts to build them with) and checked against the number of times
+//  the text shown changed.  More than that means the caching regressed,
+//  and the run fails (exit code 2).
+//
+int runRender(long frames, const string & framePath = "");
+
+//  Replay a session recorded with --record as fast as possible and report
+//  ticks/second, so identical workloads can be timed across builds.  Prints
+//  the final score and a checksum of the world state to confirm the replay
+//  matched.
+//
+int runReplay(const string & path);
@@ -0,0 +1,250 @@
+#include "InputLog.h"
+#include "GameWorld.h"
+#include <fstream>
+#include <string.h>
+
+static const char logMagic[4] = { 'L', 'I', 'N', '1' };
+
+InputLog::InputLog() {
+	seed = 0;
+	width = 0;
+	height = 0;
+	tickLength = 1.0 / 60;
+	endTick = 0;
+	next = 0;
+	fireRate = laserLife = laserVelocity = -1;
+}
+
+//  Start recording: keep what setup() depends on, then seed and set up the
+//  world with it
+//
+void InputLog::begin(GameWorld & world, uint64_t seed, int width, int height) {
+	this->seed = seed;
+	this->width = width;
+	this->height = height;
+	explosionVelocity = world.explosionVelocity;
+	events.clear();
+	next = 0;
+	endTick = 0;
+	fireRate = laserLife = laserVelocity = -1;
+	setup(world);
+}
+
+void InputLog::record(int type, unsigned long tick, int x, int y, float value) {
+	InputEvent e;
+	e.tick = tick;
+	e.type = type;
+	e.x = x;
+	e.y = y;
+	e.value = value;
+	events.push_back(e);
+}
+
+//  Log the settings that changed since the last call (call before each step)
+//
+void InputLog::recordSettings(const GameWorld & world) {
+	if (world.fireRate != fireRate) {
+		fireRate = world.fireRate;
+		record(InputFireRate, world.ticks, 0, 0, fireRate);
+	}
+	if (world.laserLife != laserLife) {
+		laserLife = world.laserLife;
+		record(InputLaserLife, world.ticks, 0, 0, laserLife);
+	}
+	if (world.laserVelocity.y != laserVelocity) {
+		laserVelocity = world.laserVelocity.y;
+		record(InputLaserVelocity, world.ticks, 0, 0, laserVelocity);
+	}
+}
+
+void InputLog::end(const GameWorld & world) {
+	endTick = world.ticks;
+}
+
+// varints: 7 bits per byte, low bits first, high bit set on all but the last
+//
+static void putVarint(ofstream & out, uint64_t v) {
+	while (v >= 0x80) {
+		out.put((char)(v | 0x80));
+		v >>= 7;
+	}
+	out.put((char)v);
+}
+
+static bool getVarint(ifstream & in, uint64_t & v) {
+	v = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int c = in.get();
+		if (c == EOF) return false;
+		v |= (uint64_t)(c & 0x7f) << shift;
+		if (!(c & 0x80)) return true;
+	}
+	return false;
+}
+
+static void putInt(ofstream & out, int v) {
+	putVarint(out, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static bool getInt(ifstream & in, int & v) {
+	uint64_t u;
+	if (!getVarint(in, u)) return false;
+	v = (int)((uint32_t)u >> 1) ^ -(int)(u & 1);
+	return true;
+}
+
+template <typename T>
+static void putRaw(ofstream & out, const T & v) {
+	out.write((const char *)&v, sizeof(v));
+}
+
+template <typename T>
+static bool getRaw(ifstream & in, T & v) {
+	return (bool)in.read((char *)&v, sizeof(v));
+}
+
+bool InputLog::save(const string & path) const {
+	ofstream out(path.c_str(), ios::binary);
+	if (!out) return false;
+
+	out.write(logMagic, sizeof(logMagic));
+	putRaw(out, seed);
+	putRaw(out, (int32_t)width);
+	putRaw(out, (int32_t)height);
+	putRaw(out, tickLength);
+	putRaw(out, explosionVelocity.x);
+	putRaw(out, explosionVelocity.y);
+	putRaw(out, explosionVelocity.z);
+	putRaw(out, (uint64_t)endTick);
+	putRaw(out, (uint32_t)events.size());
+
+	unsigned long last = 0;
+	for (int i = 0; i < events.size(); i++) {
+		const InputEvent & e = events[i];
+		putVarint(out, e.tick - last);
+		last = e.tick;
+		out.put((char)e.type);
+		switch (e.type) {
+		case InputKeyPressed:
+		case InputKeyReleased:
+			putInt(out, e.x);
+			break;
+		case InputMousePressed:
+		case InputMouseDragged:
+			putInt(out, e.x);
+			putInt(out, e.y);
+			break;
+		case InputFireRate:
+		case InputLaserLife:
+		case InputLaserVelocity:
+			putRaw(out, e.value);
+			break;
+		}
+	}
+	return (bool)out;
+}
+
+bool InputLog::load(const string & path) {
+	ifstream in(path.c_str(), ios::binary);
+	if (!in) return false;
+
+	char magic[4];
+	int32_t w, h;
+	uint64_t ticks;
+	uint32_t n;
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, logMagic, sizeof(magic)) != 0) return false;
+	if (!getRaw(in, seed) || !getRaw(in, w) || !getRaw(in, h) || !getRaw(in, tickLength) ||
+		!getRaw(in, explosionVelocity.x) || !getRaw(in, explosionVelocity.y) ||
+		!getRaw(in, explosionVelocity.z) || !getRaw(in, ticks) || !getRaw(in, n)) return false;
+	width = w;
+	height = h;
+	endTick = ticks;
+
+	events.clear();
+	events.reserve(n);
+	next = 0;
+	unsigned long tick = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		InputEvent e;
+		uint64_t delta;
+		if (!getVarint(in, delta)) return false;
+		tick += delta;
+		e.tick = tick;
+		e.type = in.get();
+		e.x = e.y = 0;
+		e.value = 0;
+		bool ok = true;
+		switch (e.type) {
+		case InputKeyPressed:
+		case InputKeyReleased:
+			ok = getInt(in, e.x);
+			break;
+		case InputMousePressed:
+		case InputMouseDragged:
+			ok = getInt(in, e.x) && getInt(in, e.y);
+			break;
+		case InputMouseReleased:
+			break;
+		case InputFireRate:
+		case InputLaserLife:
+		case InputLaserVelocity:
+			ok = getRaw(in, e.value);
+			break;
+		default:
+			ok = false;
+		}
+		if (!ok) return false;
+		events.push_back(e);
+	}
+	return true;
+}
+
+//  Seed and set up a world the way the recorded one was
+//
+void InputLog::setup(GameWorld & world) const {
+	world.setSeed(seed);
+	world.explosionVelocity = explosionVelocity;
+	world.setup(width, height);
+}
+
+//  Apply the events recorded before the world's next step
+//
+void InputLog::apply(GameWorld & world) {
+	while (next < events.size() && events[next].tick <= world.ticks) {
+		applyInput(world, events[next]);
+		next++;
+	}
+}
+
+bool InputLog::finished(const GameWorld & world) const {
+	return world.ticks >= endTick && next >= events.size();
+}
+
+void applyInput(GameWorld & world, const InputEvent & e) {
+	switch (e.type) {
+	case InputKeyPressed:
+		world.keyPressed(e.x);
+		break;
+	case InputKeyReleased:
+		world.keyReleased(e.x);
+		break;
+	case InputMousePressed:
+		world.mousePressed(e.x, e.y);
+		break;
+	case InputMouseDragged:
+		world.mouseDragged(e.x, e.y);
+		break;
+	case InputMouseReleased:
+		world.mouseReleased();
+		break;
+	case InputFireRate:
+		world.fireRate = e.value;
+		break;
+	case InputLaserLife:
+		world.laserLife = e.value;
+		break;
+	case InputLaserVelocity:
+		world.laserVelocity.y = e.value;
+		break;
+	}
+}
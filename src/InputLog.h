@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ofMain.h"
+
+class GameWorld;
+
+//  One input to the game world, stamped with the world tick it was applied
+//  before.  Besides the keys and mouse, the settings the app copies into the
+//  world from its GUI are logged too, since they change the simulation.
+//
+enum InputType {
+	InputKeyPressed, InputKeyReleased,
+	InputMousePressed, InputMouseDragged, InputMouseReleased,
+	InputFireRate, InputLaserLife, InputLaserVelocity,
+	NumInputTypes
+};
+
+struct InputEvent {
+	unsigned long tick;
+	int type;
+	int x, y;			// key in x, or mouse position
+	float value;		// new value of a setting
+};
+
+//  Records the input to a GameWorld and replays it tick for tick.
+//
+//  The log also holds everything else that decides how a session plays out:
+//  the world's random seed, playfield size, tick length and the settings
+//  given before setup().  A session replayed from the log with setup() and
+//  apply() steps exactly as it did when it was recorded, so the same
+//  workload can be timed across builds.
+//
+//  File format (little endian): the header below, then one record per event
+//  of a varint tick delta, a type byte and its arguments (zigzag varints for
+//  keys and mouse positions, 4 byte floats for settings).
+//
+class InputLog {
+public:
+	InputLog();
+
+	// recording
+	//
+	void begin(GameWorld & world, uint64_t seed, int width, int height);
+	void record(int type, unsigned long tick, int x = 0, int y = 0, float value = 0);
+	void recordSettings(const GameWorld & world);
+	void end(const GameWorld & world);
+	bool save(const string & path) const;
+
+	// replay
+	//
+	bool load(const string & path);
+	void setup(GameWorld & world) const;
+	void apply(GameWorld & world);
+	bool finished(const GameWorld & world) const;
+
+	// header
+	//
+	uint64_t seed;
+	int width, height;
+	float tickLength;			// sec
+	ofVec3f explosionVelocity;
+	unsigned long endTick;		// ticks in the session
+
+	vector<InputEvent> events;
+	int next;					// next event to replay
+
+private:
+	float fireRate, laserLife, laserVelocity;	// last settings recorded
+};
+
+void applyInput(GameWorld & world, const InputEvent & e);
@@ -0,0 +1,163 @@
+#include "Log.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+
+static std::atomic<int> currentLevel(LogInfo);
+
+void setLogLevel(LogLevel level) {
+	currentLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel logLevel() {
+	return (LogLevel)currentLevel.load(std::memory_order_relaxed);
+}
+
+static int64_t nowMicros() {
+	using namespace std::chrono;
+	static const steady_clock::time_point start = steady_clock::now();
+	return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+bool LogRateLimit::allow(int *suppressedBefore) {
+	int64_t second = nowMicros() / 1000000;
+	int64_t w = window.load(std::memory_order_relaxed);
+	if (second != w && window.compare_exchange_strong(w, second)) {
+		count.store(0, std::memory_order_relaxed);
+	}
+	if (count.fetch_add(1, std::memory_order_relaxed) >= logRateLimit) {
+		suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	*suppressedBefore = suppressed.exchange(0, std::memory_order_relaxed);
+	return true;
+}
+
+//  Bounded multi producer, single consumer ring.  Each slot's sequence number
+//  says whose turn it is: equal to the slot's position when free for the
+//  producer claiming that position, position + 1 once the message is written
+//  and ready for the writer thread.
+//
+class Logger {
+public:
+	static const int capacity = 1024;		// power of two
+	static const int maxMessage = 256;
+
+	Logger();
+	~Logger();
+	void write(LogLevel level, int suppressed, const char *format, va_list args);
+	void flush();
+
+private:
+	struct Slot {
+		std::atomic<uint64_t> seq;
+		int64_t time;			// us since startup
+		int level;
+		int suppressed;
+		char text[maxMessage];
+	};
+	Slot slots[capacity];
+	std::atomic<uint64_t> head;		// next position to claim
+	uint64_t tail;					// next position to write out (writer thread only)
+	std::atomic<uint64_t> written;	// positions written out
+	std::atomic<int> dropped;
+	std::atomic<bool> running;
+	std::thread writer;
+
+	void run();
+	bool writeNext();
+};
+
+Logger::Logger() : head(0), tail(0), written(0), dropped(0), running(true) {
+	for (int i = 0; i < capacity; i++) slots[i].seq.store(i, std::memory_order_relaxed);
+	writer = std::thread(&Logger::run, this);
+}
+
+//  Write out whatever is left before the program exits
+//
+Logger::~Logger() {
+	running.store(false);
+	writer.join();
+}
+
+void Logger::write(LogLevel level, int suppressed, const char *format, va_list args) {
+	uint64_t pos = head.load(std::memory_order_relaxed);
+	Slot *slot;
+	for (;;) {
+		slot = &slots[pos & (capacity - 1)];
+		int64_t diff = (int64_t)slot->seq.load(std::memory_order_acquire) - (int64_t)pos;
+		if (diff == 0) {
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if (diff < 0) {
+			dropped.fetch_add(1, std::memory_order_relaxed);	// full
+			return;
+		}
+		else pos = head.load(std::memory_order_relaxed);
+	}
+
+	slot->time = nowMicros();
+	slot->level = level;
+	slot->suppressed = suppressed;
+	vsnprintf(slot->text, maxMessage, format, args);
+	slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+//  Write out the next message if it's ready
+//
+bool Logger::writeNext() {
+	static const char *names[] = { "DEBUG", "INFO", "WARNING", "ERROR", "" };
+
+	Slot & slot = slots[tail & (capacity - 1)];
+	if (slot.seq.load(std::memory_order_acquire) != tail + 1) return false;
+
+	FILE *out = stderr;
+	fprintf(out, "[%10.3f] %s: %s", slot.time / 1e6, names[slot.level], slot.text);
+	if (slot.suppressed > 0) fprintf(out, " (%d similar suppressed)", slot.suppressed);
+	fputc('\n', out);
+
+	slot.seq.store(tail + capacity, std::memory_order_release);
+	tail++;
+	written.store(tail, std::memory_order_release);
+	return true;
+}
+
+void Logger::run() {
+	for (;;) {
+		bool any = false;
+		while (writeNext()) any = true;
+
+		int n = dropped.exchange(0, std::memory_order_relaxed);
+		if (n > 0) fprintf(stderr, "[%10.3f] WARNING: log full, %d messages dropped\n", nowMicros() / 1e6, n);
+		if (any || n > 0) fflush(stderr);
+
+		if (!running.load() && head.load() == tail) break;
+		if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+}
+
+void Logger::flush() {
+	uint64_t target = head.load();
+	while (written.load(std::memory_order_acquire) < target) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+//  Created on first use, so the writer thread only exists if something logs
+//
+static Logger & logger() {
+	static Logger instance;
+	return instance;
+}
+
+void logWrite(LogLevel level, int suppressed, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	logger().write(level, suppressed, format, args);
+	va_end(args);
+}
+
+void logFlush() {
+	logger().flush();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+//  Asynchronous logging.
+//
+//  LOG_ERROR("Can't load image file: %s", path.c_str()) formats the message
+//  (printf style) into a slot of a fixed size lock free ring and returns;
+//  a background thread writes the slots out to stderr (stdout is left to
+//  program output such as benchmark results).  The calling thread never
+//  waits on a slow terminal or pipe.  If the ring is full the message is
+//  dropped and counted rather than blocking, and the writer reports how
+//  many were dropped.
+//
+//  Each call site is also rate limited to logRateLimit messages a second;
+//  the next message let through says how many were suppressed.  Messages
+//  below the level set with setLogLevel() cost only a compare.
+//
+enum LogLevel { LogDebug, LogInfo, LogWarning, LogError, LogSilent };
+
+void setLogLevel(LogLevel level);
+LogLevel logLevel();
+void logWrite(LogLevel level, int suppressed, const char *format, ...)
+#ifdef __GNUC__
+	__attribute__((format(printf, 3, 4)))
+#endif
+	;
+void logFlush();		// wait until everything logged so far is written
+
+const int logRateLimit = 10;	// messages/sec per call site
+
+//  Per call site limiter: lets through up to logRateLimit messages in each
+//  one second window and counts the rest
+//
+class LogRateLimit {
+public:
+	LogRateLimit() : window(0), count(0), suppressed(0) {}
+	bool allow(int *suppressedBefore);
+private:
+	std::atomic<int64_t> window;	// current window, in whole seconds
+	std::atomic<int> count;			// messages let through this window
+	std::atomic<int> suppressed;	// messages dropped since the last one let through
+};
+
+#define LOG_AT(level, ...) \
+	do { \
+		if ((level) >= logLevel()) { \
+			static LogRateLimit logLimit; \
+			int logSuppressed; \
+			if (logLimit.allow(&logSuppressed)) logWrite((level), logSuppressed, __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LOG_DEBUG(...)   LOG_AT(LogDebug, __VA_ARGS__)
+#define LOG_INFO(...)    LOG_AT(LogInfo, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogWarning, __VA_ARGS__)
+#define LOG_ERROR(...)   LOG_AT(LogError, __VA_ARGS__)
@@ -2,8 +2,12 @@
 
 #include "ofMain.h"
 
-class ParticleForceField;
+class ParticleForce;
 
+//  Description of a particle to add to a ParticleSystem.  Once added, the
+//  particle's data lives in the system's EntityStore and is updated and
+//  drawn by the shared entity systems (see EntityStore.h).
+//
 class Particle {
 public:
 	Particle();
@@ -11,16 +15,10 @@ public:
 	ofVec3f position;
 	ofVec3f velocity;
 	ofVec3f acceleration;
-	ofVec3f forces;
 	float	damping;
 	float   mass;
-	float   lifespan;
+	float   lifespan;     // sec
 	float   radius;
-	float   birthtime;
-	void    integrate();
-	void    draw();
-	float   age();        // sec
+	float   birthtime;    // ms
 	ofColor color;
 };
-
-
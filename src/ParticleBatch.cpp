@@ -0,0 +1,82 @@
+#include "ParticleBatch.h"
+
+ParticleBatch::ParticleBatch() {
+	count = 0;
+	capacity = 0;
+}
+
+void ParticleBatch::build(const EntityStore & store, float now) {
+	int n = store.size();
+	vertices.resize(n * 6);
+	colors.resize(n * 6);
+
+	int q = 0;
+	for (int i = 0; i < n; i++) {
+		float r = store.radius[i];
+		if (store.image[i] || r <= 0) continue;
+
+		const glm::vec3 p = store.position[i];		// a copy, so the stores below can't alias it
+		glm::vec3 *v = &vertices[q * 6];
+		v[0] = glm::vec3(p.x - r, p.y - r, p.z);
+		v[1] = glm::vec3(p.x + r, p.y - r, p.z);
+		v[2] = glm::vec3(p.x + r, p.y + r, p.z);
+		v[3] = v[0];
+		v[4] = v[2];
+		v[5] = glm::vec3(p.x - r, p.y + r, p.z);
+
+		// ofMap(age, 0, lifespan, 255, 10) / 255, inline
+		//
+		float age = now - store.birthtime[i];
+		ofFloatColor c((255 - 245 * age / store.lifespan[i]) / 255.0f, 0, 0);
+		ofFloatColor *col = &colors[q * 6];
+		for (int k = 0; k < 6; k++) col[k] = c;
+		q++;
+	}
+	count = q;
+}
+
+//  A white disc with a soft edge in the alpha, so the quads look like the
+//  flat spheres they replace
+//
+void ParticleBatch::makeDisc() const {
+	const int size = discSize;
+	ofPixels pixels;
+	pixels.allocate(size, size, 4);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			float dx = x + 0.5f - size / 2.0f, dy = y + 0.5f - size / 2.0f;
+			float d = sqrt(dx * dx + dy * dy) / (size / 2.0f);
+			pixels.setColor(x, y, ofColor(255, 255, 255, discAlpha(d) * 255));
+		}
+	}
+	disc.loadData(pixels);
+}
+
+void ParticleBatch::draw() const {
+	if (count == 0) return;
+	if (!disc.isAllocated()) makeDisc();
+
+	int n = count * 6;
+	if (n > capacity) {
+		// grow to everything built, with the same texture coordinates for
+		// every quad
+		//
+		capacity = vertices.size();
+		glm::vec2 t0 = disc.getCoordFromPercent(0, 0);
+		glm::vec2 t1 = disc.getCoordFromPercent(1, 1);
+		glm::vec2 quad[6] = { t0, glm::vec2(t1.x, t0.y), t1, t0, t1, glm::vec2(t0.x, t1.y) };
+		texCoords.resize(capacity);
+		for (int i = 0; i < capacity; i++) texCoords[i] = quad[i % 6];
+		vbo.setVertexData(&vertices[0], capacity, GL_DYNAMIC_DRAW);
+		vbo.setColorData(&colors[0], capacity, GL_DYNAMIC_DRAW);
+		vbo.setTexCoordData(&texCoords[0], capacity, GL_DYNAMIC_DRAW);
+	}
+	else {
+		vbo.updateVertexData(&vertices[0], n);
+		vbo.updateColorData(&colors[0], n);
+	}
+
+	disc.bind();
+	vbo.draw(GL_TRIANGLES, 0, n);
+	disc.unbind();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ofMain.h"
+#include "EntityStore.h"
+
+//  Draws all the particles in a store with one draw call.
+//
+//  build() writes a quad per particle (entities with a radius and no
+//  image), colored by age as drawEntities() colors its spheres, into
+//  plain arrays; it doesn't touch GL, so it can be benchmarked on its own.
+//  draw() uploads the arrays into a dynamic vertex buffer (reallocating it
+//  only when it must grow) and draws the quads textured with a soft disc.
+//
+class ParticleBatch {
+public:
+	ParticleBatch();
+	void build(const EntityStore & store, float now);
+	void draw() const;
+	int size() const { return count; }		// particles built
+
+	// the disc's alpha at distance d from its center, as a fraction of the
+	// radius
+	//
+	static float discAlpha(float d) { return ofClamp((1 - d) * discSize / 2, 0, 1); }
+	static const int discSize = 32;			// texels across
+
+	vector<glm::vec3> vertices;		// 6 per particle (two triangles)
+	vector<ofFloatColor> colors;
+
+private:
+	int count;
+	mutable ofVbo vbo;
+	mutable ofTexture disc;
+	mutable vector<glm::vec2> texCoords;
+	mutable int capacity;				// vertices the vbo holds
+
+	void makeDisc() const;
+};
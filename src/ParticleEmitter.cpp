@@ -2,6 +2,7 @@
 //  Kevin M. Smith - CS 134 SJSU
 
 #include "ParticleEmitter.h"
+#include "Log.h"
 
 ParticleEmitter::ParticleEmitter() {
 	sys = new ParticleSystem();
@@ -12,7 +13,7 @@ ParticleEmitter::ParticleEmitter() {
 ParticleEmitter::ParticleEmitter(ParticleSystem *s) {
 	if (s == NULL)
 	{
-		cout << "fatal error: null particle system passed to ParticleEmitter()" << endl;
+		LOG_ERROR("null particle system passed to ParticleEmitter()");
 		ofExit();
 	}
 	sys = s;
@@ -27,6 +28,15 @@ ParticleEmitter::~ParticleEmitter() {
 	if (createdSys) delete sys;
 }
 
+//  Spawn into a particle system owned by someone else (several emitters can
+//  share one system).  The owner of a shared system updates and draws it.
+//
+void ParticleEmitter::setSystem(ParticleSystem *s) {
+	if (createdSys) delete sys;
+	sys = s;
+	createdSys = false;
+}
+
 void ParticleEmitter::init() {
 	rate = 1;
 	velocity = ofVec3f(1000, 1000, 0);
@@ -44,7 +54,7 @@ void ParticleEmitter::init() {
 
 
 
-void ParticleEmitter::draw() {
+void ParticleEmitter::draw(float now) {
 	if (visible) {
 		switch (type) {
 		case DirectionalEmitter:
@@ -58,20 +68,22 @@ void ParticleEmitter::draw() {
 			break;
 		}
 	}
-	sys->draw();  
+	if (createdSys) sys->draw(now);  
 }
-void ParticleEmitter::start() {
+void ParticleEmitter::start(float now) {
 	started = true;
-	lastSpawned = ofGetElapsedTimeMillis();
+	lastSpawned = now;
 }
 
 void ParticleEmitter::stop() {
 	started = false;
 	fired = false;
 }
-void ParticleEmitter::update() {
+//  now is the current time in ms, dt the time step in seconds.
+//
+void ParticleEmitter::update(float now, float dt, Random & random) {
 
-	float time = ofGetElapsedTimeMillis();
+	float time = now;
 
 	if (oneShot && started) {
 		if (!fired) {
@@ -79,7 +91,7 @@ void ParticleEmitter::update() {
 			// spawn a new particle(s)
 			//
 			for (int i = 0; i < groupSize; i++)
-				spawn(time);
+				spawn(time, random);
 
 			lastSpawned = time;
 		}
@@ -92,17 +104,17 @@ void ParticleEmitter::update() {
 		// spawn a new particle(s)
 		//
 		for (int i= 0; i < groupSize; i++)
-			spawn(time);
+			spawn(time, random);
 	
 		lastSpawned = time;
 	}
 
-	sys->update();
+	if (createdSys) sys->update(now, dt, random);
 }
 
 // spawn a single particle.  time is current time of birth
 //
-void ParticleEmitter::spawn(float time) {
+void ParticleEmitter::spawn(float time, Random & random) {
 
 	Particle particle;
 
@@ -112,7 +124,7 @@ void ParticleEmitter::spawn(float time) {
 	switch (type) {
 	case RadialEmitter:
 	{
-		ofVec3f dir = ofVec3f(ofRandom(-1, 1), ofRandom(-1, 1), 0);
+		ofVec3f dir = ofVec3f(random.range(-1, 1), random.range(-1, 1), 0);
 		float speed = velocity.length();
 		particle.velocity = dir.getNormalized() * speed;
 		particle.position.set(position);
@@ -15,9 +15,10 @@ public:
 	ParticleEmitter(ParticleSystem *s);
 	~ParticleEmitter();
 	void init();
-	void draw();
-	void start();
+	void draw(float now);
+	void start(float now);
 	void stop();
+	void setSystem(ParticleSystem *s);
 	void setLifespan(const float life)   { lifespan = life; }
 	void setVelocity(const ofVec3f &vel) { velocity = vel; }
 	void setRate(const float r) { rate = r; }
@@ -25,8 +26,8 @@ public:
 	void setEmitterType(EmitterType t) { type = t; }
 	void setGroupSize(int s) { groupSize = s; }
 	void setOneShot(bool s) { oneShot = s; }
-	void update();
-	void spawn(float time);
+	void update(float now, float dt, Random & random);
+	void spawn(float time, Random & random);
 	ParticleSystem *sys;
 	float rate;         // per sec
 	bool oneShot;
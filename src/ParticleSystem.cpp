@@ -4,7 +4,17 @@
 #include "ParticleSystem.h"
 
 void ParticleSystem::add(const Particle &p) {
-	particles.push_back(p);
+	int i = particles.create();
+	particles.position[i] = p.position;
+	particles.lastPosition[i] = p.position;
+	particles.velocity[i] = p.velocity;
+	particles.acceleration[i] = p.acceleration;
+	particles.mass[i] = p.mass;
+	particles.damping[i] = p.damping;
+	particles.birthtime[i] = p.birthtime;
+	particles.lifespan[i] = p.lifespan == -1 ? -1 : p.lifespan * 1000;	// sec => ms
+	particles.radius[i] = p.radius;
+	particles.color[i] = p.color;
 }
 
 void ParticleSystem::addForce(ParticleForce *f) {
@@ -12,12 +22,12 @@ void ParticleSystem::addForce(ParticleForce *f) {
 }
 
 void ParticleSystem::remove(int i) {
-	particles.erase(particles.begin() + i);
+	particles.remove(i);
 }
 
 void ParticleSystem::setLifespan(float l) {
 	for (int i = 0; i < particles.size(); i++) {
-		particles[i].lifespan = l;
+		particles.lifespan[i] = l * 1000;
 	}
 }
 
@@ -27,32 +37,23 @@ void ParticleSystem::reset() {
 	}
 }
 
-void ParticleSystem::update() {
+//  now is the current time in ms, dt the time step in seconds.
+//
+void ParticleSystem::update(float now, float dt, Random & random) {
 	// check if empty and just return
 	if (particles.size() == 0) return;
 
-	vector<Particle>::iterator p = particles.begin();
-	vector<Particle>::iterator tmp;
-
 	// check which particles have exceed their lifespan and delete
-	// from list.  When deleting multiple objects from a vector while
-	// traversing at the same time, we need to use an iterator.
+	// from the store.
 	//
-	while (p != particles.end()) {
-		if (p->lifespan != -1 && p->age() > p->lifespan) {
-			tmp = particles.erase(p);
-			p = tmp;
-		}
-		else p++;
-	}
+	expireEntities(particles, now);
 
 	// update forces on all particles first 
 	//
-	for (int i = 0; i < particles.size(); i++) {
-		for (int k = 0; k < forces.size(); k++) {
-			if (!forces[k]->applied)
-				forces[k]->updateForce( &particles[i] );
-		}
+	for (int k = 0; k < forces.size(); k++) {
+		if (forces[k]->applied) continue;
+		for (int i = 0; i < particles.size(); i++)
+			forces[k]->updateForce(particles, i, random);
 	}
 
 	// update all forces only applied once to "applied"
@@ -65,8 +66,7 @@ void ParticleSystem::update() {
 
 	// integrate all the particles in the store
 	//
-	for (int i = 0; i < particles.size(); i++)
-		particles[i].integrate();
+	integrateEntities(particles, dt);
 
 }
 
@@ -74,12 +74,11 @@ void ParticleSystem::update() {
 //
 int ParticleSystem::removeNear(const ofVec3f & point, float dist) { return 0; }
 
-//  draw the particle cloud
+//  draw the particle cloud, in one draw call
 //
-void ParticleSystem::draw() {
-	for (int i = 0; i < particles.size(); i++) {
-		particles[i].draw();
-	}
+void ParticleSystem::draw(float now) {
+	batch.build(particles, now);
+	batch.draw();
 }
 
 
@@ -89,11 +88,11 @@ GravityForce::GravityForce(const ofVec3f &g) {
 	gravity = g;
 }
 
-void GravityForce::updateForce(Particle * particle) {
+void GravityForce::updateForce(EntityStore & store, int i, Random &) {
 	//
 	// f = mg
 	//
-	particle->forces += gravity * particle->mass;
+	store.forces[i] += glm::vec3(gravity) * store.mass[i];
 }
 
 // Turbulence Force Field 
@@ -103,14 +102,14 @@ TurbulenceForce::TurbulenceForce(const ofVec3f &min, const ofVec3f &max) {
 	tmax = max;
 }
 
-void TurbulenceForce::updateForce(Particle * particle) {
+void TurbulenceForce::updateForce(EntityStore & store, int i, Random & random) {
 	//
 	// We are going to add a little "noise" to a particles
 	// forces to achieve a more natual look to the motion
 	//
-	particle->forces.x += ofRandom(tmin.x, tmax.x);
-	particle->forces.y += ofRandom(tmin.y, tmax.y);
-	particle->forces.z += ofRandom(tmin.z, tmax.z);
+	store.forces[i].x += random.range(tmin.x, tmax.x);
+	store.forces[i].y += random.range(tmin.y, tmax.y);
+	store.forces[i].z += random.range(tmin.z, tmax.z);
 }
 
 // Impulse Radial Force - this is a "one shot" force that
@@ -121,11 +120,11 @@ ImpulseRadialForce::ImpulseRadialForce(float magnitude) {
 	applyOnce = true;
 }
 
-void ImpulseRadialForce::updateForce(Particle * particle) {
+void ImpulseRadialForce::updateForce(EntityStore & store, int i, Random & random) {
 
 	// we basically create a random direction for each particle
 	// the force is only added once after it is triggered.
 	//
-	ofVec3f dir = ofVec3f(ofRandom(-1, 1), ofRandom(-1, 1), ofRandom(-1, 1));
-	particle->forces += dir.getNormalized() * magnitude;
+	ofVec3f dir = ofVec3f(random.range(-1, 1), random.range(-1, 1), random.range(-1, 1));
+	store.forces[i] += glm::vec3(dir.getNormalized() * magnitude);
 }
\ No newline at end of file
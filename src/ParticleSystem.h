@@ -3,16 +3,22 @@
 
 #include "ofMain.h"
 #include "Particle.h"
+#include "EntityStore.h"
+#include "ParticleBatch.h"
+#include "Random.h"
 
 
 //  Pure Virtual Function Class - must be subclassed to create new forces.
+//  updateForce() adds to the forces of particle i in the store.  Forces
+//  that need randomness take it from the system's generator.
 //
 class ParticleForce {
 protected:
 public:
 	bool applyOnce = false;
 	bool applied = false;
-	virtual void updateForce(Particle *) = 0;
+	virtual ~ParticleForce() {}
+	virtual void updateForce(EntityStore &, int i, Random &) = 0;
 };
 
 class ParticleSystem {
@@ -20,13 +26,15 @@ public:
 	void add(const Particle &);
 	void addForce(ParticleForce *);
 	void remove(int);
-	void update();
+	void update(float now, float dt, Random & random);
 	void setLifespan(float);
 	void reset();
 	int removeNear(const ofVec3f & point, float dist);
-	void draw();
-	vector<Particle> particles;
+	void draw(float now);
+	int size() const { return particles.size(); }
+	EntityStore particles;
 	vector<ParticleForce *> forces;
+	ParticleBatch batch;		// for draw()
 };
 
 
@@ -37,19 +45,19 @@ class GravityForce: public ParticleForce {
 	ofVec3f gravity;
 public:
 	GravityForce(const ofVec3f & gravity);
-	void updateForce(Particle *);
+	void updateForce(EntityStore &, int i, Random &);
 };
 
 class TurbulenceForce : public ParticleForce {
 	ofVec3f tmin, tmax;
 public:
 	TurbulenceForce(const ofVec3f & min, const ofVec3f &max);
-	void updateForce(Particle *);
+	void updateForce(EntityStore &, int i, Random &);
 };
 
 class ImpulseRadialForce : public ParticleForce {
 	float magnitude;
 public:
 	ImpulseRadialForce(float magnitude); 
-	void updateForce(Particle *);
+	void updateForce(EntityStore &, int i, Random &);
 };
@@ -0,0 +1,53 @@
+#include "Pool.h"
+#include <stdlib.h>
+
+//  Room for the free list link, rounded up to keep blocks aligned
+//
+static size_t roundBlockSize(size_t size, size_t link) {
+	const size_t align = alignof(max_align_t);
+	size_t block = size < link ? link : size;
+	return (block + align - 1) & ~(align - 1);
+}
+
+Pool::Pool(size_t blockSize, int blocksPerChunk) {
+	this->blockSize = blockSize ? roundBlockSize(blockSize, sizeof(FreeBlock)) : 0;
+	this->blocksPerChunk = blocksPerChunk;
+	freeList = NULL;
+	allocated = 0;
+}
+
+Pool::~Pool() {
+	for (int i = 0; i < chunks.size(); i++) ::free(chunks[i]);
+}
+
+//  Add a chunk of blocks to the free list
+//
+void Pool::grow() {
+	char *chunk = (char *)malloc(blockSize * blocksPerChunk);
+	if (!chunk) throw std::bad_alloc();
+	chunks.push_back(chunk);
+	for (int i = blocksPerChunk - 1; i >= 0; i--) {
+		FreeBlock *b = (FreeBlock *)(chunk + i * blockSize);
+		b->next = freeList;
+		freeList = b;
+	}
+}
+
+//  size must fit in a block; the first call fixes the block size if it
+//  wasn't given
+//
+void *Pool::alloc(size_t size) {
+	if (blockSize == 0) blockSize = roundBlockSize(size, sizeof(FreeBlock));
+	if (!freeList) grow();
+	FreeBlock *b = freeList;
+	freeList = b->next;
+	allocated++;
+	return b;
+}
+
+void Pool::free(void *p) {
+	FreeBlock *b = (FreeBlock *)p;
+	b->next = freeList;
+	freeList = b;
+	allocated--;
+}
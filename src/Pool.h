@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include <new>
+
+//  Fixed size block allocator.
+//
+//  Blocks are carved out of chunks of blocksPerChunk at a time and freed
+//  blocks go on a free list for reuse, so a container that keeps allocating
+//  and freeing nodes of one size stops touching the heap once the pool has
+//  grown to its high water mark.  Chunks are only returned when the pool is
+//  destroyed.
+//
+//  A block size of 0 means it is set by the first alloc() (see
+//  PoolAllocator, where the node size of a std::map or std::list isn't
+//  known up front).  Either way blocks are at least a pointer in size and
+//  rounded up to keep them aligned, so getBlockSize() may be more than
+//  was asked for.
+//
+class Pool {
+public:
+	Pool(size_t blockSize = 0, int blocksPerChunk = 256);
+	~Pool();
+	Pool(const Pool &) = delete;
+	Pool & operator=(const Pool &) = delete;
+
+	void *alloc(size_t size);
+	void free(void *p);
+	size_t getBlockSize() const { return blockSize; }
+	int allocated;			// blocks in use
+
+private:
+	struct FreeBlock { FreeBlock *next; };
+	size_t blockSize;
+	int blocksPerChunk;
+	FreeBlock *freeList;
+	std::vector<char *> chunks;
+	void grow();
+};
+
+//  STL allocator taking single objects from a pool, for node based
+//  containers:
+//
+//      Pool pool;
+//      map<int, float, less<int>, PoolAllocator<pair<const int, float>>> m(less<int>(), PoolAllocator<pair<const int, float>>(pool));
+//
+//  Requests for several objects, or objects bigger than the pool's blocks,
+//  go to the heap.
+//
+template <typename T>
+class PoolAllocator {
+public:
+	typedef T value_type;
+
+	PoolAllocator(Pool & pool) : pool(&pool) {}
+	template <typename U> PoolAllocator(const PoolAllocator<U> & other) : pool(other.pool) {}
+
+	T *allocate(size_t n) {
+		if (n == 1 && (pool->getBlockSize() == 0 || sizeof(T) <= pool->getBlockSize()))
+			return (T *)pool->alloc(sizeof(T));
+		return (T *)::operator new(n * sizeof(T));
+	}
+	void deallocate(T *p, size_t n) {
+		if (n == 1 && sizeof(T) <= pool->getBlockSize()) pool->free(p);
+		else ::operator delete(p);
+	}
+
+	template <typename U> bool operator==(const PoolAllocator<U> & other) const { return pool == other.pool; }
+	template <typename U> bool operator!=(const PoolAllocator<U> & other) const { return pool != other.pool; }
+
+	Pool *pool;
+};
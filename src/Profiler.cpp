@@ -0,0 +1,168 @@
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <mutex>
+
+static thread_local Profiler *currentProfiler = NULL;
+
+Profiler::Profiler(int maxFrames) {
+	this->maxFrames = maxFrames;
+	enabled = true;
+	threadId = 1;
+	frames.resize(maxFrames);
+	frameCount = 0;
+	frame = NULL;
+	depth = 0;
+
+	// all profilers share one time base so their traces line up
+	//
+	static const uint64_t processStart = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	epoch = processStart;
+}
+
+//  Send the calling thread's PROFILE_SCOPEs to this profiler
+//
+void Profiler::makeCurrent() {
+	currentProfiler = this;
+}
+
+Profiler *Profiler::current() {
+	return currentProfiler;
+}
+
+uint64_t Profiler::now() const {
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - epoch;
+}
+
+//  Start recording a frame, reusing the oldest frame's storage
+//
+void Profiler::beginFrame() {
+	if (!enabled) return;
+	frame = &frames[frameCount % maxFrames];
+	frame->samples.clear();
+	frame->start = now();
+	depth = 0;
+}
+
+void Profiler::endFrame() {
+	if (!frame) return;
+	frame->end = now();
+	frame = NULL;
+	frameCount++;
+}
+
+//  Scopes outside a frame aren't recorded (-1)
+//
+int Profiler::begin(const char *name) {
+	if (!frame) return -1;
+	ProfileSample s;
+	s.name = name;
+	s.depth = depth++;
+	s.thread = 0;
+	s.start = now();
+	s.end = s.start;
+	frame->samples.push_back(s);
+	return frame->samples.size() - 1;
+}
+
+void Profiler::end(int sample) {
+	if (!frame || sample < 0) return;
+	frame->samples[sample].end = now();
+	depth--;
+}
+
+//  A sample timed on another thread, nested in the scopes open on this one
+//
+void Profiler::add(const char *name, uint64_t start, uint64_t end, int thread) {
+	if (!frame) return;
+	ProfileSample s;
+	s.name = name;
+	s.depth = depth;
+	s.thread = thread;
+	s.start = start;
+	s.end = end;
+	frame->samples.push_back(s);
+}
+
+//  Samples keep their names by pointer, so names built at run time are
+//  kept here for good
+//
+const char *Profiler::intern(const string & name) {
+	static std::mutex lock;
+	static std::set<string> names;
+	std::lock_guard<std::mutex> guard(lock);
+	return names.insert(name).first->c_str();
+}
+
+//  Mean ms per frame of each sample name over the recorded frames,
+//  indented by nesting, in the order the names first appear
+//
+void Profiler::drawOverlay(float x, float y) const {
+	int n = min(frameCount, maxFrames);
+	if (n == 0) return;
+
+	vector<const char *> names;
+	vector<int> depths;
+	typedef PoolAllocator<pair<const char * const, double> > TotalAllocator;
+	TotalAllocator allocator(overlayPool);
+	map<const char *, double, less<const char *>, TotalAllocator> total(allocator);
+	double frameTotal = 0;
+	for (int f = 0; f < n; f++) {
+		const Frame & fr = frames[f];
+		frameTotal += fr.end - fr.start;
+		for (int i = 0; i < fr.samples.size(); i++) {
+			const ProfileSample & s = fr.samples[i];
+			if (total.find(s.name) == total.end()) {
+				names.push_back(s.name);
+				depths.push_back(s.depth);
+				total[s.name] = 0;
+			}
+			total[s.name] += s.end - s.start;
+		}
+	}
+
+	const float lineHeight = 14;
+	ofSetColor(0, 0, 0, 180);
+	ofDrawRectangle(x - 5, y - lineHeight, 320, (names.size() + 2) * lineHeight);
+	ofSetColor(ofColor::white);
+	char line[128];
+	snprintf(line, sizeof(line), "frame %.2f ms (last %d frames)", frameTotal / n / 1e6, n);
+	ofDrawBitmapString(line, x, y);
+	for (int i = 0; i < names.size(); i++) {
+		snprintf(line, sizeof(line), "%*s%-24s %7.3f ms", depths[i] * 2, "", names[i], total[names[i]] / n / 1e6);
+		ofDrawBitmapString(line, x, y + (i + 1) * lineHeight);
+	}
+}
+
+//  Chrome trace event format: one complete ("X") event per sample, with
+//  times in microseconds
+//
+bool Profiler::writeTrace(const string & path) const {
+	ofstream out(path.c_str());
+	if (!out) return false;
+
+	int n = min(frameCount, maxFrames);
+	int first = frameCount - n;
+	bool comma = false;
+	out << fixed << setprecision(3);
+	out << "{\"traceEvents\":[" << endl;
+	for (int f = first; f < frameCount; f++) {
+		const Frame & fr = frames[f % maxFrames];
+		out << (comma ? ",\n" : "") << "{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId << ",\"ts\":"
+			<< fr.start / 1000.0 << ",\"dur\":" << (fr.end - fr.start) / 1000.0 << "}";
+		comma = true;
+		for (int i = 0; i < fr.samples.size(); i++) {
+			const ProfileSample & s = fr.samples[i];
+			int tid = s.thread ? threadId * 100 + s.thread : threadId;
+			out << ",\n{\"name\":\"" << s.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":"
+				<< s.start / 1000.0 << ",\"dur\":" << (s.end - s.start) / 1000.0 << "}";
+		}
+	}
+	out << "\n]}" << endl;
+	return (bool)out;
+}
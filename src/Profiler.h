@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ofMain.h"
+#include <stdint.h>
+#include "Pool.h"
+
+//  Scoped frame profiler.
+//
+//  PROFILE_SCOPE("name") times the rest of the enclosing block.  Samples go
+//  to the profiler made current on the calling thread with makeCurrent();
+//  on threads without one (headless runs, batch workers) a scope costs a
+//  thread local load and a branch.  Define LANDER_NO_PROFILE to compile the
+//  scopes out entirely.
+//
+//  Work timed on other threads (a TaskGraph's tasks on its pool's workers)
+//  is handed back with add() once it's done, and shows in the trace on a
+//  row per worker.
+//
+//  The profiler keeps the last maxFrames frames between beginFrame() and
+//  endFrame(), which can be summarised on screen with drawOverlay() or
+//  written as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+struct ProfileSample {
+	const char *name;		// must be a string literal (not copied)
+	int depth;				// nesting level, 0 => outermost
+	int thread;				// 0 => the profiler's thread, else the pool worker that ran it
+	uint64_t start, end;	// ns since the profiler was created
+};
+
+class Profiler {
+public:
+	Profiler(int maxFrames = 300);
+	void makeCurrent();
+	static Profiler *current();
+
+	void beginFrame();
+	void endFrame();
+	int begin(const char *name);
+	void end(int sample);
+	void add(const char *name, uint64_t start, uint64_t end, int thread);
+	uint64_t now() const;
+	static const char *intern(const string & name);		// a name that lasts as long as a literal
+
+	void drawOverlay(float x, float y) const;
+	bool writeTrace(const string & path) const;
+
+	int maxFrames;
+	bool enabled;
+	int threadId;			// "tid" of the trace events
+
+private:
+	struct Frame {
+		uint64_t start, end;
+		vector<ProfileSample> samples;
+	};
+	vector<Frame> frames;		// ring of the last maxFrames frames
+	int frameCount;				// frames completed since creation
+	Frame *frame;				// frame being recorded, NULL between frames
+	int depth;
+	uint64_t epoch;
+	mutable Pool overlayPool;	// map nodes for drawOverlay(), reused each frame
+};
+
+//  Times its own lifetime as one sample of the current profiler
+//
+class ProfileScope {
+public:
+	ProfileScope(const char *name) {
+		profiler = Profiler::current();
+		if (profiler) sample = profiler->begin(name);
+	}
+	~ProfileScope() {
+		if (profiler) profiler->end(sample);
+	}
+private:
+	Profiler *profiler;
+	int sample;
+};
+
+#ifdef LANDER_NO_PROFILE
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+//  Small, fast random number generator (xorshift64*).
+//
+//  Unlike ofRandom() there is no shared global state: each GameWorld owns
+//  one, so worlds can run on different threads and the same seed always
+//  gives the same sequence.
+//
+class Random {
+public:
+	Random(uint64_t seed = 1) { setSeed(seed); }
+
+	//  mix the seed (splitmix64) so that nearby seeds give unrelated
+	//  sequences and a seed of 0 is still usable
+	//
+	void setSeed(uint64_t seed) {
+		state = mix(seed);
+		if (state == 0) state = 1;
+	}
+
+	static uint64_t mix(uint64_t seed) {
+		uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	//  seed of the nth of several streams drawn from one seed.  seed + n
+	//  would make stream n of seed s the same as stream n - 1 of s + 1.
+	//
+	static uint64_t stream(uint64_t seed, uint64_t n) {
+		return mix(seed ^ (n * 0x9E3779B97F4A7C15ull));
+	}
+
+	uint32_t next() {
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 32);
+	}
+
+	//  uniform float in [min, max)
+	//
+	float range(float min, float max) {
+		return min + (max - min) * ((next() >> 8) * (1.0f / 16777216.0f));
+	}
+
+	uint64_t state;
+};
@@ -0,0 +1,81 @@
+#include "RenderBackend.h"
+#include "TextMesh.h"
+#include "ParticleBatch.h"
+
+GLRenderBackend::GLRenderBackend() {
+	pushed = false;
+	batch.setMode(OF_PRIMITIVE_TRIANGLES);
+}
+
+void GLRenderBackend::setColor(const ofColor & color) {
+	ofSetColor(color);
+}
+
+void GLRenderBackend::setTransform(const glm::mat4 *m) {
+	if (pushed) ofPopMatrix();
+	if (m) {
+		ofPushMatrix();
+		ofMultMatrix(*m);
+	}
+	pushed = m != NULL;
+}
+
+//  All the quads as one textured mesh with per-vertex colors
+//
+void GLRenderBackend::images(const ofImage & image, const ImageQuad *quads, int n) {
+	const ofTexture & texture = image.getTexture();
+	glm::vec2 t0 = texture.getCoordFromPercent(0, 0);
+	glm::vec2 t1 = texture.getCoordFromPercent(1, 1);
+
+	batch.clear();
+	for (int i = 0; i < n; i++) {
+		const ImageQuad & q = quads[i];
+		glm::vec3 p[4] = {
+			glm::vec3(q.x, q.y, 0), glm::vec3(q.x + q.w, q.y, 0),
+			glm::vec3(q.x + q.w, q.y + q.h, 0), glm::vec3(q.x, q.y + q.h, 0)
+		};
+		glm::vec2 t[4] = { t0, glm::vec2(t1.x, t0.y), t1, glm::vec2(t0.x, t1.y) };
+		static const int corners[6] = { 0, 1, 2, 0, 2, 3 };
+		ofFloatColor color = q.color;
+		for (int k = 0; k < 6; k++) {
+			batch.addVertex(p[corners[k]]);
+			batch.addTexCoord(t[corners[k]]);
+			batch.addColor(color);
+		}
+	}
+	texture.bind();
+	batch.draw();
+	texture.unbind();
+}
+
+void GLRenderBackend::rect(float x, float y, float w, float h) {
+	ofDrawRectangle(x, y, w, h);
+}
+
+void GLRenderBackend::triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) {
+	ofDrawTriangle(a, b, c);
+}
+
+void GLRenderBackend::line(const glm::vec3 & a, const glm::vec3 & b) {
+	ofDrawLine(a, b);
+}
+
+void GLRenderBackend::mesh(const ofMesh & mesh) {
+	mesh.draw();
+}
+
+void GLRenderBackend::circle(float x, float y, float radius) {
+	ofDrawCircle(x, y, radius);
+}
+
+void GLRenderBackend::sphere(const glm::vec3 & center, float radius) {
+	ofDrawSphere(center, radius);
+}
+
+void GLRenderBackend::text(const TextMesh & text, float x, float y) {
+	text.draw(x, y);
+}
+
+void GLRenderBackend::particles(const ParticleBatch & batch) {
+	batch.draw();
+}
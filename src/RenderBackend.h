@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ofMain.h"
+
+class TextMesh;
+class ParticleBatch;
+
+//  One image of a batch: where it goes and the color it's tinted with
+//
+struct ImageQuad {
+	float x, y, w, h;
+	ofColor color;
+};
+
+//  Where a RenderQueue's sorted commands are drawn.  submit() only calls
+//  setColor() and setTransform() when they change, and hands over runs of
+//  same-texture images together, so a backend doesn't need to track state
+//  of its own to avoid redundant changes.
+//
+class RenderBackend {
+public:
+	virtual ~RenderBackend() {}
+
+	virtual void setColor(const ofColor & color) = 0;
+	virtual void setTransform(const glm::mat4 *m) = 0;		// NULL for none
+
+	virtual void images(const ofImage & image, const ImageQuad *quads, int n) = 0;
+	virtual void rect(float x, float y, float w, float h) = 0;
+	virtual void triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) = 0;
+	virtual void line(const glm::vec3 & a, const glm::vec3 & b) = 0;
+	virtual void mesh(const ofMesh & mesh) = 0;			// triangles, in the current color
+	virtual void circle(float x, float y, float radius) = 0;
+	virtual void sphere(const glm::vec3 & center, float radius) = 0;
+	virtual void text(const TextMesh & text, float x, float y) = 0;
+	virtual void particles(const ParticleBatch & batch) = 0;
+};
+
+//  Draws with openFrameworks into the current GL context
+//
+class GLRenderBackend : public RenderBackend {
+public:
+	GLRenderBackend();
+
+	void setColor(const ofColor & color);
+	void setTransform(const glm::mat4 *m);
+
+	void images(const ofImage & image, const ImageQuad *quads, int n);
+	void rect(float x, float y, float w, float h);
+	void triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c);
+	void line(const glm::vec3 & a, const glm::vec3 & b);
+	void mesh(const ofMesh & mesh);
+	void circle(float x, float y, float radius);
+	void sphere(const glm::vec3 & center, float radius);
+	void text(const TextMesh & text, float x, float y);
+	void particles(const ParticleBatch & batch);
+
+private:
+	bool pushed;				// a transform is on the matrix stack
+	ofMesh batch;
+};
@@ -0,0 +1,239 @@
+#include "RenderQueue.h"
+#include "TextMesh.h"
+#include "ParticleBatch.h"
+
+RenderQueue::RenderQueue() {
+	layer = LayerWorld;
+	color = ofColor::white;
+	transform = -1;
+}
+
+//  Start a new frame.  The arrays keep their capacity, so a steady frame
+//  doesn't allocate.
+//
+void RenderQueue::clear() {
+	commands.clear();
+	order.clear();
+	textures.clear();
+	transforms.clear();
+	layer = LayerWorld;
+	color = ofColor::white;
+	transform = -1;
+}
+
+void RenderQueue::setTransform(const glm::mat4 & m) {
+	transforms.push_back(m);
+	transform = transforms.size() - 1;
+}
+
+//  Textures get small ids in order of first use; there are only a handful
+//  a frame
+//
+RenderQueue::RenderCommand & RenderQueue::add(RenderOp op, const void *source, const void *texture) {
+	int id = 0;
+	if (texture) {
+		for (int i = 0; i < textures.size() && id == 0; i++) {
+			if (textures[i] == texture) id = i + 1;
+		}
+		if (id == 0) {
+			textures.push_back(texture);
+			id = textures.size();
+		}
+	}
+
+	commands.push_back(RenderCommand());
+	RenderCommand & c = commands.back();
+	c.op = op;
+	c.layer = layer;
+	c.texture = id;
+	c.transform = transform;
+	c.color = color;
+	c.source = source;
+	return c;
+}
+
+void RenderQueue::image(const ofImage & image, float x, float y) {
+	RenderCommand & c = add(RenderImage, &image, &image);
+	c.a = glm::vec3(x, y, 0);
+	c.w = image.getWidth();
+	c.h = image.getHeight();
+}
+
+void RenderQueue::sphere(const glm::vec3 & center, float radius) {
+	RenderCommand & c = add(RenderSphere, NULL, NULL);
+	c.a = center;
+	c.w = radius;
+}
+
+void RenderQueue::rect(float x, float y, float w, float h) {
+	RenderCommand & c = add(RenderRect, NULL, NULL);
+	c.a = glm::vec3(x, y, 0);
+	c.w = w;
+	c.h = h;
+}
+
+void RenderQueue::triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) {
+	RenderCommand & cmd = add(RenderTriangle, NULL, NULL);
+	cmd.a = a;
+	cmd.b = b;
+	cmd.c = c;
+}
+
+void RenderQueue::line(const glm::vec3 & a, const glm::vec3 & b) {
+	RenderCommand & c = add(RenderLine, NULL, NULL);
+	c.a = a;
+	c.b = b;
+}
+
+void RenderQueue::circle(float x, float y, float radius) {
+	RenderCommand & c = add(RenderCircle, NULL, NULL);
+	c.a = glm::vec3(x, y, 0);
+	c.w = radius;
+}
+
+void RenderQueue::mesh(const ofMesh & mesh) {
+	add(RenderMesh, &mesh, NULL);
+}
+
+//  Text is keyed on its font, whose glyph texture it binds
+//
+void RenderQueue::text(const TextMesh & text, float x, float y) {
+	RenderCommand & c = add(RenderText, &text, text.getFont());
+	c.a = glm::vec3(x, y, 0);
+}
+
+//  A particle batch binds its own texture, so it's a texture of its own
+//
+void RenderQueue::particles(const ParticleBatch & batch) {
+	add(RenderParticles, &batch, &batch);
+}
+
+//  Key: layer, op, texture, then the command's index, which keeps the
+//  recorded order for commands with the same state
+//
+void RenderQueue::sort() {
+	order.resize(commands.size());
+	for (int i = 0; i < commands.size(); i++) {
+		const RenderCommand & c = commands[i];
+		order[i] = ((uint64_t)c.layer << 56) | ((uint64_t)c.op << 48) | ((uint64_t)c.texture << 32) | i;
+	}
+	std::sort(order.begin(), order.end());
+	recorded = measure(false);
+	sorted = measure(true);
+}
+
+const RenderQueue::RenderCommand & RenderQueue::command(bool sorted, int i) const {
+	return commands[sorted ? order[i] & 0xffffffff : i];
+}
+
+//  Images with the same texture and no transform go in one mesh, whatever
+//  their colors
+//
+bool RenderQueue::batches(const RenderCommand & a, const RenderCommand & b) const {
+	return a.op == RenderImage && b.op == RenderImage && a.texture == b.texture &&
+		a.transform < 0 && b.transform < 0;
+}
+
+//  Count draw calls and state changes the way submit() makes them
+//
+RenderStats RenderQueue::measure(bool sorted) const {
+	RenderStats stats = {};
+	stats.commands = commands.size();
+	int texture = 0;
+	ofColor color = ofColor::white;
+	bool haveColor = false;
+	for (int i = 0; i < commands.size(); i++) {
+		const RenderCommand & c = command(sorted, i);
+		if (i > 0 && batches(command(sorted, i - 1), c)) continue;
+		stats.batches++;
+		if (c.texture != texture) {
+			if (c.texture != 0) stats.textureChanges++;
+			texture = c.texture;
+		}
+		// images carry their colors in the mesh, leaving the current color
+		// undefined
+		//
+		if (c.op == RenderImage) haveColor = false;
+		else if (!haveColor || c.color != color) {
+			stats.colorChanges++;
+			color = c.color;
+			haveColor = true;
+		}
+	}
+	return stats;
+}
+
+//  Walk the sorted commands, handing runs of same-texture images to the
+//  backend together and only changing the color and transform when they
+//  change
+//
+void RenderQueue::submit(RenderBackend & backend) const {
+	ofColor color;
+	bool haveColor = false;
+	int transform = -1;
+	int n = order.size();
+	for (int i = 0; i < n; ) {
+		const RenderCommand & c = command(true, i);
+		int last = i;
+		while (last + 1 < n && batches(command(true, last), command(true, last + 1))) last++;
+
+		if (c.transform != transform) {
+			backend.setTransform(c.transform >= 0 ? &transforms[c.transform] : NULL);
+			transform = c.transform;
+		}
+
+		if (c.op == RenderImage) {
+			quads.resize(last - i + 1);
+			for (int k = i; k <= last; k++) {
+				const RenderCommand & b = command(true, k);
+				ImageQuad & q = quads[k - i];
+				q.x = b.a.x;
+				q.y = b.a.y;
+				q.w = b.w;
+				q.h = b.h;
+				q.color = b.color;
+			}
+			backend.images(*(const ofImage *)c.source, &quads[0], quads.size());
+			haveColor = false;		// the images' colors leave the current color undefined
+		}
+		else {
+			if (!haveColor || c.color != color) {
+				backend.setColor(c.color);
+				color = c.color;
+				haveColor = true;
+			}
+			draw(backend, c);
+		}
+		i = last + 1;
+	}
+	if (transform >= 0) backend.setTransform(NULL);
+}
+
+void RenderQueue::draw(RenderBackend & backend, const RenderCommand & c) const {
+	switch (c.op) {
+	case RenderSphere:
+		backend.sphere(c.a, c.w);
+		break;
+	case RenderRect:
+		backend.rect(c.a.x, c.a.y, c.w, c.h);
+		break;
+	case RenderTriangle:
+		backend.triangle(c.a, c.b, c.c);
+		break;
+	case RenderLine:
+		backend.line(c.a, c.b);
+		break;
+	case RenderCircle:
+		backend.circle(c.a.x, c.a.y, c.w);
+		break;
+	case RenderMesh:
+		backend.mesh(*(const ofMesh *)c.source);
+		break;
+	case RenderText:
+		backend.text(*(const TextMesh *)c.source, c.a.x, c.a.y);
+		break;
+	case RenderParticles:
+		backend.particles(*(const ParticleBatch *)c.source);
+		break;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ofMain.h"
+#include "RenderBackend.h"
+
+//  Draw layers, back to front.  Commands are only reordered within a layer.
+//
+enum RenderLayer { LayerBackground, LayerWorld, LayerEffects, LayerOverlay, LayerHud };
+
+//  Kinds of draw, in the order they're drawn within a layer (shapes under
+//  images, text on top)
+//
+enum RenderOp { RenderRect, RenderTriangle, RenderCircle, RenderLine, RenderMesh, RenderSphere, RenderParticles, RenderImage, RenderText };
+
+//  Counts for one frame's commands in the order they would be submitted
+//
+struct RenderStats {
+	int commands;
+	int batches;				// draw calls: runs of images sharing a texture count once
+	int textureChanges;
+	int colorChanges;
+	int stateChanges() const { return textureChanges + colorChanges; }
+};
+
+//  Draw calls recorded for a frame, then sorted and submitted together.
+//
+//  The draw code records what it wants drawn, in any order, into a layer.
+//  sort() orders the commands by layer, then by kind of draw (the shader),
+//  then by texture, keeping the recorded order among commands with the
+//  same state.  Same-texture images that are then next to each other are
+//  drawn as one textured mesh with per-vertex colors, and color and
+//  texture changes are only made when they actually change.
+//
+//  sort() also works out the stats for the frame both as recorded and as
+//  sorted, without touching GL, so they can be checked without a GPU.
+//  submit() draws through a RenderBackend: GL on screen, or the software
+//  rasterizer for headless runs.
+//
+class RenderQueue {
+public:
+	RenderQueue();
+
+	void clear();
+	void setLayer(RenderLayer layer) { this->layer = layer; }
+	void setColor(const ofColor & color) { this->color = color; }
+	void setTransform(const glm::mat4 & m);		// for the following commands
+	void clearTransform() { transform = -1; }
+
+	void image(const ofImage & image, float x, float y);
+	void sphere(const glm::vec3 & center, float radius);
+	void rect(float x, float y, float w, float h);
+	void triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c);
+	void line(const glm::vec3 & a, const glm::vec3 & b);
+	void circle(float x, float y, float radius);
+	void mesh(const ofMesh & mesh);			// kept by the caller until submitted
+	void text(const TextMesh & text, float x, float y);
+	void particles(const ParticleBatch & batch);
+
+	void sort();
+	void submit(RenderBackend & backend) const;		// draw the sorted commands
+	int size() const { return commands.size(); }
+
+	RenderStats recorded;		// as recorded, by sort()
+	RenderStats sorted;			// as submitted, by sort()
+
+private:
+	struct RenderCommand {
+		uint8_t op;
+		uint8_t layer;
+		uint16_t texture;		// index into textures, 0 = none
+		int transform;			// index into transforms, -1 = none
+		ofColor color;
+		const void *source;		// the ofImage, ofMesh, TextMesh or ParticleBatch
+		glm::vec3 a, b, c;		// positions (images, rects and circles use a.x, a.y)
+		float w, h;				// size, or radius in w
+	};
+	vector<RenderCommand> commands;
+	vector<uint64_t> order;		// sort keys, command index in the low bits
+	vector<const void *> textures;
+	vector<glm::mat4> transforms;
+	RenderLayer layer;
+	ofColor color;
+	int transform;
+	mutable vector<ImageQuad> quads;
+
+	RenderCommand & add(RenderOp op, const void *source, const void *texture);
+	RenderStats measure(bool sorted) const;
+	const RenderCommand & command(bool sorted, int i) const;
+	bool batches(const RenderCommand & a, const RenderCommand & b) const;
+	void draw(RenderBackend & backend, const RenderCommand & c) const;
+};
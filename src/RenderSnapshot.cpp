@@ -0,0 +1,36 @@
+#include "RenderSnapshot.h"
+#include "GameWorld.h"
+
+RenderSnapshot::RenderSnapshot() {
+	time = 0;
+	ticks = 0;
+	score = 0;
+	roundTime = 0;
+	idle = true;
+	gameOver = false;
+	collisionCount = 0;
+	stepTime = 0;
+}
+
+void RenderSnapshot::capture(GameWorld & world) {
+	time = world.getTime();
+	ticks = world.ticks;
+
+	shipMatrix = world.ship.getMatrix();
+	shipPosition = world.ship.getPosition();
+	shipHeading = world.ship.heading();
+	for (int i = 0; i < 3; i++) shipVerts[i] = world.ship.verts[i];
+
+	lasers = world.turret->sys->sprites;
+	invaders.resize(world.invaders.size());
+	for (int i = 0; i < world.invaders.size(); i++) {
+		invaders[i] = world.invaders[i]->sys->sprites;
+	}
+	explosions = world.explosions.particles;
+
+	score = world.score;
+	roundTime = world.roundTime();
+	idle = world.idle;
+	gameOver = world.gameOver;
+	collisionCount = world.collisionCount;
+}
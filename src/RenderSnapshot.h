@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ofMain.h"
+#include "EntityStore.h"
+
+class GameWorld;
+
+//  Everything the app needs to draw one moment of a GameWorld, copied out
+//  of the world at the end of a step so it can be drawn on another thread
+//  while the world moves on.
+//
+//  Sprites and particles are copies of their entity stores (the image
+//  pointers in them point at images owned by the world's emitters, which
+//  don't change after setup).  Assigning into a snapshot that has been
+//  used before reuses its vectors, so capturing doesn't allocate once the
+//  snapshot has grown to the busiest frame.
+//
+class RenderSnapshot {
+public:
+	RenderSnapshot();
+	void capture(GameWorld & world);
+
+	float time;						// world time, ms
+	unsigned long ticks;
+
+	// the lander
+	//
+	glm::mat4 shipMatrix;
+	glm::vec3 shipPosition;
+	glm::vec3 shipHeading;
+	glm::vec3 shipVerts[3];
+
+	EntityStore lasers;
+	vector<EntityStore> invaders;	// one store per invader emitter
+	EntityStore explosions;
+
+	// HUD and game state
+	//
+	int score;
+	float roundTime;				// sec
+	bool idle;
+	bool gameOver;
+	unsigned long collisionCount;
+	float stepTime;					// ms the simulation took for the last tick
+};
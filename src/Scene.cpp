@@ -0,0 +1,126 @@
+#include "Scene.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+
+Scene::Scene() {
+	width = 0;
+	height = 0;
+	background = NULL;
+	ship = NULL;
+	scoreFont = NULL;
+	timerFont = NULL;
+	drawHeading = false;
+	drawPaths = false;
+	pathScale = 200;
+	pathCycles = 4;
+	pathBuilds = 0;
+	pathWidth = pathHeight = -1;
+	builtScale = builtCycles = 0;
+}
+
+void Scene::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+}
+
+void Scene::record(RenderQueue & q, const RenderSnapshot & s) {
+	q.setLayer(LayerBackground);
+	q.setColor(ofColor::white);
+	if (background) q.image(*background, 0, 0);
+
+	q.setLayer(LayerWorld);
+	for (int i = 0; i < s.invaders.size(); i++) queueEntities(q, s.invaders[i], s.time);
+
+	if (drawPaths) {
+		if (width != pathWidth || height != pathHeight || pathScale != builtScale || pathCycles != builtCycles) {
+			buildPath();
+		}
+		q.setColor(ofColor::white);
+		q.mesh(path);
+	}
+
+	queueEntities(q, s.lasers, s.time);
+
+	q.setColor(ofColor::white);
+	q.setTransform(s.shipMatrix);
+	q.triangle(s.shipVerts[0], s.shipVerts[1], s.shipVerts[2]);
+	if (ship) q.image(*ship, -ship->getWidth() / 2, -ship->getHeight() / 2.0);
+	q.clearTransform();
+
+	q.setLayer(LayerEffects);
+	explosions.build(s.explosions, s.time);
+	q.particles(explosions);
+
+	// draw heading vector
+	//
+	if (drawHeading) {
+		q.setLayer(LayerOverlay);
+		q.setColor(ofColor::red);
+		q.line(s.shipPosition, s.shipPosition + s.shipHeading * 100);
+	}
+
+	PROFILE_SCOPE("hud");
+	ALLOC_TAG("hud");
+	int t = (int)s.roundTime;
+	q.setLayer(LayerHud);
+	q.setColor(ofColor::black);
+	if (s.idle) {
+		hudPrompt.setText(scoreFont, "Press Space to Play!");
+		if (scoreFont) q.text(hudPrompt, (width / 2) - 200, (height / 2) - 50);
+	}
+	else {
+		hudScore.setNumber(scoreFont, "Score: ", s.score);
+		if (scoreFont) q.text(hudScore, 10, 50);
+		hudTime.setNumber(timerFont, "Time: ", t);
+		if (timerFont) q.text(hudTime, (width - 300), 50);
+	}
+	if (s.gameOver) {
+		hudGameOver.setText(timerFont, "GAME OVER");
+		if (timerFont) q.text(hudGameOver, (width / 2) - 200, (height / 2) + 50);
+	}
+}
+
+//  The path as a band two pixels wide (it used to be drawn as a dot of
+//  radius 1 at every pixel across the window), offset along the curve's
+//  normal so steep parts are as thick as flat ones
+//
+void Scene::buildPath() {
+	pathWidth = width;
+	pathHeight = height;
+	builtScale = pathScale;
+	builtCycles = pathCycles;
+	pathBuilds++;
+
+	path.clear();
+	path.setMode(OF_PRIMITIVE_TRIANGLES);
+	path.setUsage(GL_STATIC_DRAW);
+	glm::vec3 lastTop, lastBottom;
+	for (int i = 0; i < width; i++) {
+		glm::vec3 p = curveEval(i);
+		glm::vec3 d = curveEval(i + 0.5f) - curveEval(i - 0.5f);
+		glm::vec3 n = glm::normalize(glm::vec3(-d.y, d.x, 0));
+		glm::vec3 top = p - n, bottom = p + n;
+		if (i > 0) {
+			path.addVertex(lastTop);
+			path.addVertex(top);
+			path.addVertex(bottom);
+			path.addVertex(lastTop);
+			path.addVertex(bottom);
+			path.addVertex(lastBottom);
+		}
+		lastTop = top;
+		lastBottom = bottom;
+	}
+}
+
+// Given x in pixel coordinates, return (x, y, z) on the sin wave
+// Note that "z" is not used, so it is set to "0".
+//
+// The curve's amplitude is pathScale and it makes pathCycles cycles
+// across the window.
+//
+glm::vec3 Scene::curveEval(float x) const {
+	// x is in screen coordinates and his in [0, WindowWidth]
+	float u = (pathCycles * x * PI) / width;
+	return (glm::vec3(x, -pathScale * sin(u) + (height / 2), 0));
+}
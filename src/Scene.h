@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ofMain.h"
+#include "RenderQueue.h"
+#include "RenderSnapshot.h"
+#include "TextMesh.h"
+#include "ParticleBatch.h"
+
+//  Records what the game shows for a snapshot of the world into a render
+//  queue: the background, the sprites and particles, the debug overlays
+//  and the HUD.  Recording doesn't touch GL, so the window (drawing the
+//  queue with GL) and headless runs (drawing it with the software
+//  rasterizer) make the same draw list.
+//
+//  The images and fonts belong to the caller; any left NULL aren't drawn.
+//  Headless runs have no fonts, which need a GL context to load.
+//
+//  The path overlay is a mesh kept in a vertex buffer, rebuilt only when
+//  the window is resized or the path's scale or cycles change, so it's one
+//  draw call however wide the window is.
+//
+class Scene {
+public:
+	Scene();
+	void resize(int width, int height);
+	void record(RenderQueue & q, const RenderSnapshot & s);
+	glm::vec3 curveEval(float x) const;
+
+	int width, height;					// window size, set by resize()
+	const ofImage *background;
+	const ofImage *ship;
+	const ofTrueTypeFont *scoreFont;
+	const ofTrueTypeFont *timerFont;
+
+	// debug overlays
+	//
+	bool drawHeading;
+	bool drawPaths;
+	float pathScale;					// the path's amplitude
+	float pathCycles;					// and cycles across the window
+
+	int pathBuilds;						// times the path mesh has been built
+
+private:
+	ParticleBatch explosions;
+
+	// the path overlay and what it was built for
+	//
+	ofVboMesh path;
+	int pathWidth, pathHeight;
+	float builtScale, builtCycles;
+	void buildPath();
+
+	// the HUD's lines of text, rebuilt only when they change
+	//
+	TextMesh hudScore;
+	TextMesh hudTime;
+	TextMesh hudPrompt;
+	TextMesh hudGameOver;
+};
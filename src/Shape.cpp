@@ -0,0 +1,98 @@
+#include "Shape.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TRIANGLE_SSE
+#endif
+
+void TriangleShape::draw() {
+	const glm::mat4 &T = getMatrix();
+
+	//ofSetColor(ofColor::darkBlue);
+
+	ofPushMatrix();
+
+	ofMultMatrix(T);
+	ofDrawTriangle(verts[0], verts[1], verts[2]);
+	spriteImage.draw(-spriteImage.getWidth() / 2, -spriteImage.getHeight() / 2.0);
+	ofPopMatrix();
+}
+
+//  Transform the triangle into world space and rebuild its edge functions.
+//  Call once per frame after the shape moves; inside() and insideBatch()
+//  use the result.  Does nothing if the transform hasn't changed.
+//
+void TriangleShape::updateEdges() {
+	if (edgeVersion == getVersion()) return;
+	edgeVersion = getVersion();
+
+	const glm::mat4 &T = getMatrix();
+	glm::vec3 p[3];
+	for (int i = 0; i < 3; i++) {
+		p[i] = T * glm::vec4(verts[i], 1);
+	}
+
+	// orient the edges so the inside is positive whatever the winding
+	//
+	float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+	float sign = area < 0 ? -1.0 : 1.0;
+
+	for (int i = 0; i < 3; i++) {
+		glm::vec3 &a = p[i];
+		glm::vec3 &b = p[(i + 1) % 3];
+		edgeA[i] = sign * -(b.y - a.y);
+		edgeB[i] = sign * (b.x - a.x);
+		edgeC[i] = -(edgeA[i] * a.x + edgeB[i] * a.y);
+	}
+}
+
+//  inside() test method - point in triangle using the edge functions
+//
+bool TriangleShape::inside(const glm::vec3 & p) const {
+	for (int i = 0; i < 3; i++) {
+		if (edgeA[i] * p.x + edgeB[i] * p.y + edgeC[i] < 0) return false;
+	}
+	return true;
+}
+
+//  Test n points (given as separate x and y arrays) against the triangle.
+//  hits[i] is set to 1 if point i is inside, else 0.  Returns the number of
+//  points inside.  Four points are tested at a time with SSE when available.
+//
+int TriangleShape::insideBatch(const float *xs, const float *ys, int n, unsigned char *hits) const {
+	int count = 0;
+	int i = 0;
+
+#ifdef TRIANGLE_SSE
+	__m128 zero = _mm_setzero_ps();
+	__m128 a0 = _mm_set1_ps(edgeA[0]), b0 = _mm_set1_ps(edgeB[0]), c0 = _mm_set1_ps(edgeC[0]);
+	__m128 a1 = _mm_set1_ps(edgeA[1]), b1 = _mm_set1_ps(edgeB[1]), c1 = _mm_set1_ps(edgeC[1]);
+	__m128 a2 = _mm_set1_ps(edgeA[2]), b2 = _mm_set1_ps(edgeB[2]), c2 = _mm_set1_ps(edgeC[2]);
+
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(xs + i);
+		__m128 y = _mm_loadu_ps(ys + i);
+		__m128 e0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, x), _mm_mul_ps(b0, y)), c0);
+		__m128 e1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a1, x), _mm_mul_ps(b1, y)), c1);
+		__m128 e2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a2, x), _mm_mul_ps(b2, y)), c2);
+		__m128 in = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+		int mask = _mm_movemask_ps(in);
+		for (int k = 0; k < 4; k++) {
+			hits[i + k] = (mask >> k) & 1;
+			count += hits[i + k];
+		}
+	}
+#endif
+
+	// remaining points (or all of them without SSE)
+	//
+	for (; i < n; i++) {
+		float x = xs[i], y = ys[i];
+		bool in = edgeA[0] * x + edgeB[0] * y + edgeC[0] >= 0 &&
+			edgeA[1] * x + edgeB[1] * y + edgeC[1] >= 0 &&
+			edgeA[2] * x + edgeB[2] * y + edgeC[2] >= 0;
+		hits[i] = in;
+		count += in;
+	}
+	return count;
+}
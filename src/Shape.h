@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ofMain.h"
+#include "TransformObject.h"
+
+//  Shape base class
+//
+class Shape : public TransformObject {
+public:
+	Shape() {}
+	virtual void draw() {}
+	virtual bool inside() { return false; }
+
+	vector<glm::vec3> verts;
+};
+
+//  TriangleShape
+//
+class TriangleShape : public Shape {
+public:
+	
+	TriangleShape(glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
+		verts.push_back(p1);
+		verts.push_back(p2);
+		verts.push_back(p3);
+		updateEdges();
+	}
+	void updateEdges();
+	bool inside(const glm::vec3 & p) const;
+	int insideBatch(const float *xs, const float *ys, int n, unsigned char *hits) const;
+	void draw();
+	ofImage spriteImage;
+
+	// Edge functions of the triangle in world space, rebuilt by updateEdges()
+	// whenever the transform has changed.  A point is inside when
+	// a*x + b*y + c >= 0  for all three edges, so inside tests need no trig
+	// or normalization.
+	//
+	float edgeA[3], edgeB[3], edgeC[3];
+	unsigned int edgeVersion = ~0u;	// transform version the edges were built for
+
+	// Get heading vector for the ship (cached, see TransformObject)
+	//
+	const glm::vec3 & heading() {
+		return getHeading();
+	}
+
+	// Physics data goes here  (for integrate() );
+	//
+	ofVec3f thrust;
+	ofVec3f accel;
+	float damping;
+	float mass;
+	ofVec3f force;
+
+	//  Integrator Function - dt is the time step in seconds
+	//
+	void integrate(float dt) {
+		
+		
+		ofVec3f velocity = thrust * heading();
+		//cout << velocity << endl;
+		//cout << heading() << endl;
+		// (1) update position from velocity and time interval
+		// (2) update velocity (based on acceleration
+		// (3) multiply final result by the damping factor to sim drag
+		//
+	
+		//cout << velocity << endl;
+		// a still ship keeps its cached matrix and edges
+		//
+		if (velocity.length() > 0) setPosition(position + glm::vec3(velocity));
+		velocity += accel * dt;
+		velocity = velocity * damping;
+	}
+};
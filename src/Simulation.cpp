@@ -0,0 +1,147 @@
+#include "Simulation.h"
+#include "Log.h"
+#include <chrono>
+#include <fstream>
+
+Simulation::Simulation(GameWorld & world) : world(world), running(false),
+	shotSounds(0), explosionSounds(0), traceRequested(false), graphRequested(false) {
+	record = NULL;
+	replay = NULL;
+	maxTicksBehind = 5;
+	tickLength = 1.0 / 60;
+	profiler.threadId = 2;
+}
+
+Simulation::~Simulation() {
+	stop();
+}
+
+void Simulation::start(float tickLength) {
+	if (running) return;
+	this->tickLength = tickLength;
+	if (record) record->tickLength = tickLength;
+
+	// publish the starting state so the app has something to draw
+	//
+	snapshots.writeBuffer().capture(world);
+	snapshots.publish();
+
+	running = true;
+	thread = std::thread(&Simulation::run, this);
+}
+
+void Simulation::stop() {
+	if (!running) return;
+	running = false;
+	thread.join();
+}
+
+//  Queue input for the next tick.  If the simulation has fallen a whole
+//  queue behind the input is dropped rather than stalling the app.
+//
+void Simulation::post(const InputEvent & e) {
+	if (!input.push(e)) LOG_WARNING("Simulation input queue full, dropping input");
+}
+
+void Simulation::requestTrace(const string & path) {
+	if (traceRequested) return;
+	tracePath = path;
+	traceRequested = true;
+}
+
+void Simulation::requestGraph(const string & path) {
+	if (graphRequested) return;
+	graphPath = path;
+	graphRequested = true;
+}
+
+//  Tick at the fixed rate, sleeping between ticks.  If the thread falls
+//  more than maxTicksBehind ticks behind real time it skips ahead instead
+//  of running a burst of ticks to catch up.
+//
+void Simulation::run() {
+	typedef std::chrono::steady_clock Clock;
+	const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double>(tickLength));
+
+	profiler.makeCurrent();
+	Clock::time_point next = Clock::now();
+	while (running) {
+		Clock::time_point now = Clock::now();
+		if (now < next) {
+			std::this_thread::sleep_until(next);
+			continue;
+		}
+		if (now - next > tickDuration * maxTicksBehind) next = now;
+
+		tick();
+		next += tickDuration;
+
+		if (traceRequested) {
+			if (!profiler.writeTrace(tracePath)) LOG_ERROR("Can't write trace file: %s", tracePath.c_str());
+			traceRequested = false;
+		}
+		if (graphRequested) {
+			writeGraph();
+			graphRequested = false;
+		}
+	}
+}
+
+//  Dump the world's system graph as Graphviz and log its critical path
+//
+void Simulation::writeGraph() {
+	ofstream out(graphPath.c_str());
+	world.systems.writeDot(out);
+	if (!out) {
+		LOG_ERROR("Can't write task graph: %s", graphPath.c_str());
+		return;
+	}
+
+	double ms;
+	vector<int> path = world.systems.criticalPath(&ms);
+	string names;
+	for (int i = 0; i < path.size(); i++) {
+		if (i > 0) names += " -> ";
+		names += world.systems.name(path[i]);
+	}
+	LOG_INFO("Critical path %.3f ms: %s", ms, names.c_str());
+}
+
+//  Apply the input for this tick, step the world and publish the result
+//
+void Simulation::tick() {
+	profiler.beginFrame();
+	uint64_t start = profiler.now();
+
+	if (replay) {
+		if (replay->finished(world)) {
+			profiler.endFrame();
+			return;
+		}
+		replay->apply(world);
+	}
+	else {
+		InputEvent e;
+		while (input.pop(e)) {
+			e.tick = world.ticks;
+			if (record) record->record(e.type, e.tick, e.x, e.y, e.value);
+			applyInput(world, e);
+		}
+	}
+
+	world.step(tickLength);
+	shotSounds += world.shotSounds;
+	explosionSounds += world.explosionSounds;
+	world.shotSounds = 0;
+	world.explosionSounds = 0;
+
+	{
+		PROFILE_SCOPE("snapshot");
+		RenderSnapshot & s = snapshots.writeBuffer();
+		s.capture(world);
+		s.stepTime = (profiler.now() - start) / 1e6;
+		snapshots.publish();
+	}
+	profiler.endFrame();
+}
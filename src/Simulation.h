@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ofMain.h"
+#include "GameWorld.h"
+#include "InputLog.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
+#include "Profiler.h"
+#include <atomic>
+#include <thread>
+
+//  Runs a GameWorld on its own thread at a fixed tick rate, so simulation
+//  and rendering overlap instead of taking turns.
+//
+//  The two threads share no locks.  Input (keys, mouse and GUI settings,
+//  as InputEvents) goes to the simulation through a single producer, single
+//  consumer queue and is applied between ticks.  After every tick the
+//  simulation captures a RenderSnapshot into a triple buffer, and the app
+//  draws whatever snapshot is newest.  Sounds the world asks for are
+//  counted in atomics the app takes.
+//
+//  Once start()ed, the world belongs to the simulation thread; the app must
+//  not touch it again until stop().
+//
+class Simulation {
+public:
+	Simulation(GameWorld & world);
+	~Simulation();
+	Simulation(const Simulation &) = delete;
+	Simulation & operator=(const Simulation &) = delete;
+
+	void start(float tickLength);
+	void stop();
+
+	// app thread
+	//
+	void post(const InputEvent & e);
+	const RenderSnapshot & latest() { return snapshots.read(); }
+	int takeShotSounds() { return shotSounds.exchange(0); }
+	int takeExplosionSounds() { return explosionSounds.exchange(0); }
+	void requestTrace(const string & path);
+	void requestGraph(const string & path);
+
+	// set before start()
+	//
+	InputLog *record;			// log the input applied, or NULL
+	InputLog *replay;			// play this back and ignore post()ed input, or NULL
+	int maxTicksBehind;			// drop time rather than run more ticks than this to catch up
+
+	Profiler profiler;			// times each tick on the simulation thread
+
+private:
+	GameWorld & world;
+	float tickLength;			// sec
+	std::thread thread;
+	std::atomic<bool> running;
+
+	SpscQueue<InputEvent, 256> input;
+	TripleBuffer<RenderSnapshot> snapshots;
+	std::atomic<int> shotSounds;
+	std::atomic<int> explosionSounds;
+
+	std::atomic<bool> traceRequested;
+	string tracePath;			// written before traceRequested is set
+
+	std::atomic<bool> graphRequested;
+	string graphPath;			// written before graphRequested is set
+
+	void run();
+	void writeGraph();
+	void tick();
+};
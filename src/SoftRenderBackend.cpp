@@ -0,0 +1,243 @@
+#include "SoftRenderBackend.h"
+#include "TextMesh.h"
+#include "ParticleBatch.h"
+#include <fstream>
+
+SoftRenderBackend::SoftRenderBackend(int width, int height) {
+	this->width = 0;
+	this->height = 0;
+	color = ofColor::white;
+	transformed = false;
+	allocate(width, height);
+}
+
+void SoftRenderBackend::allocate(int width, int height) {
+	this->width = max(width, 0);
+	this->height = max(height, 0);
+	buffer.assign(this->width * this->height * 4, 0);
+}
+
+void SoftRenderBackend::clear(const ofColor & color) {
+	for (int i = 0; i < buffer.size(); i += 4) {
+		buffer[i] = color.r;
+		buffer[i + 1] = color.g;
+		buffer[i + 2] = color.b;
+		buffer[i + 3] = color.a;
+	}
+	this->color = ofColor::white;
+	transformed = false;
+}
+
+void SoftRenderBackend::setTransform(const glm::mat4 *m) {
+	transformed = m != NULL;
+	if (m) transform = *m;
+}
+
+glm::vec2 SoftRenderBackend::apply(const glm::vec3 & p) const {
+	if (!transformed) return glm::vec2(p.x, p.y);
+	glm::vec4 q = transform * glm::vec4(p, 1);
+	return glm::vec2(q.x, q.y);
+}
+
+//  How much the transform scales lengths (for radii)
+//
+float SoftRenderBackend::scale() const {
+	return transformed ? glm::length(glm::vec3(transform[0])) : 1;
+}
+
+//  Source over, with a in 0..255
+//
+void SoftRenderBackend::blend(int x, int y, int r, int g, int b, int a) {
+	unsigned char *d = &buffer[(y * width + x) * 4];
+	int ia = 255 - a;
+	d[0] = (r * a + d[0] * ia + 127) / 255;
+	d[1] = (g * a + d[1] * ia + 127) / 255;
+	d[2] = (b * a + d[2] * ia + 127) / 255;
+	d[3] = a + (d[3] * ia + 127) / 255;
+}
+
+static float edge(const glm::vec2 & a, const glm::vec2 & b, float x, float y) {
+	return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+//  With y down and the triangle wound so its area is positive, the top
+//  edge runs left to right and the left edges run upwards
+//
+static bool topLeft(const glm::vec2 & a, const glm::vec2 & b) {
+	return (a.y == b.y && b.x > a.x) || b.y < a.y;
+}
+
+void SoftRenderBackend::fillTriangle(const glm::vec2 & a, const glm::vec2 & b0, const glm::vec2 & c0, const ofColor & color) {
+	glm::vec2 b = b0, c = c0;
+	float area = edge(a, b, c.x, c.y);
+	if (area == 0 || color.a == 0) return;
+	if (area < 0) swap(b, c);
+
+	int x0 = max(0, (int)floor(min(a.x, min(b.x, c.x))));
+	int x1 = min(width - 1, (int)ceil(max(a.x, max(b.x, c.x))));
+	int y0 = max(0, (int)floor(min(a.y, min(b.y, c.y))));
+	int y1 = min(height - 1, (int)ceil(max(a.y, max(b.y, c.y))));
+	bool tl0 = topLeft(b, c), tl1 = topLeft(c, a), tl2 = topLeft(a, b);
+
+	for (int y = y0; y <= y1; y++) {
+		float py = y + 0.5f;
+		for (int x = x0; x <= x1; x++) {
+			float px = x + 0.5f;
+			float w0 = edge(b, c, px, py), w1 = edge(c, a, px, py), w2 = edge(a, b, px, py);
+			if (w0 < 0 || w1 < 0 || w2 < 0) continue;
+			if ((w0 == 0 && !tl0) || (w1 == 0 && !tl1) || (w2 == 0 && !tl2)) continue;
+			blend(x, y, color.r, color.g, color.b, color.a);
+		}
+	}
+}
+
+void SoftRenderBackend::fillDisc(const glm::vec2 & center, float radius, const ofColor & color, bool soft) {
+	if (radius <= 0 || color.a == 0) return;
+	int x0 = max(0, (int)floor(center.x - radius));
+	int x1 = min(width - 1, (int)ceil(center.x + radius));
+	int y0 = max(0, (int)floor(center.y - radius));
+	int y1 = min(height - 1, (int)ceil(center.y + radius));
+
+	for (int y = y0; y <= y1; y++) {
+		float dy = y + 0.5f - center.y;
+		for (int x = x0; x <= x1; x++) {
+			float dx = x + 0.5f - center.x;
+			float d = sqrt(dx * dx + dy * dy) / radius;
+			if (d > 1) continue;
+			int a = soft ? (int)(ParticleBatch::discAlpha(d) * color.a) : color.a;
+			if (a > 0) blend(x, y, color.r, color.g, color.b, a);
+		}
+	}
+}
+
+//  Each pixel whose center falls in a quad is mapped back through the
+//  transform to the image and takes the nearest texel
+//
+void SoftRenderBackend::images(const ofImage & image, const ImageQuad *quads, int n) {
+	const ofPixels & pixels = image.getPixels();
+	const unsigned char *src = pixels.getData();
+	int pw = pixels.getWidth(), ph = pixels.getHeight(), channels = pixels.getNumChannels();
+	if (!src || pw == 0 || ph == 0) return;
+	glm::mat4 inverse = transformed ? glm::inverse(transform) : glm::mat4(1);
+
+	for (int i = 0; i < n; i++) {
+		const ImageQuad & q = quads[i];
+		if (q.w <= 0 || q.h <= 0 || q.color.a == 0) continue;
+		glm::vec2 c[4] = {
+			apply(glm::vec3(q.x, q.y, 0)), apply(glm::vec3(q.x + q.w, q.y, 0)),
+			apply(glm::vec3(q.x + q.w, q.y + q.h, 0)), apply(glm::vec3(q.x, q.y + q.h, 0))
+		};
+		float minX = c[0].x, maxX = c[0].x, minY = c[0].y, maxY = c[0].y;
+		for (int k = 1; k < 4; k++) {
+			minX = min(minX, c[k].x);
+			maxX = max(maxX, c[k].x);
+			minY = min(minY, c[k].y);
+			maxY = max(maxY, c[k].y);
+		}
+		int x0 = max(0, (int)floor(minX)), x1 = min(width - 1, (int)ceil(maxX));
+		int y0 = max(0, (int)floor(minY)), y1 = min(height - 1, (int)ceil(maxY));
+
+		for (int y = y0; y <= y1; y++) {
+			for (int x = x0; x <= x1; x++) {
+				glm::vec2 l(x + 0.5f, y + 0.5f);
+				if (transformed) l = glm::vec2(inverse * glm::vec4(l.x, l.y, 0, 1));
+				float u = (l.x - q.x) / q.w, v = (l.y - q.y) / q.h;
+				if (u < 0 || u >= 1 || v < 0 || v >= 1) continue;
+
+				const unsigned char *t = src + ((int)(v * ph) * pw + (int)(u * pw)) * channels;
+				int r = t[0], g = channels >= 3 ? t[1] : t[0], b = channels >= 3 ? t[2] : t[0];
+				int a = channels == 4 ? t[3] : (channels == 2 ? t[1] : 255);
+				a = a * q.color.a / 255;
+				if (a > 0) blend(x, y, r * q.color.r / 255, g * q.color.g / 255, b * q.color.b / 255, a);
+			}
+		}
+	}
+}
+
+void SoftRenderBackend::rect(float x, float y, float w, float h) {
+	glm::vec2 a = apply(glm::vec3(x, y, 0)), b = apply(glm::vec3(x + w, y, 0));
+	glm::vec2 c = apply(glm::vec3(x + w, y + h, 0)), d = apply(glm::vec3(x, y + h, 0));
+	fillTriangle(a, b, c, color);
+	fillTriangle(a, c, d, color);
+}
+
+void SoftRenderBackend::triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) {
+	fillTriangle(apply(a), apply(b), apply(c), color);
+}
+
+//  One pixel wide, a pixel per step along the longer axis
+//
+void SoftRenderBackend::line(const glm::vec3 & a, const glm::vec3 & b) {
+	if (color.a == 0) return;
+	glm::vec2 p0 = apply(a), p1 = apply(b);
+	int steps = (int)ceil(max(fabs(p1.x - p0.x), fabs(p1.y - p0.y)));
+	for (int i = 0; i <= steps; i++) {
+		glm::vec2 p = steps > 0 ? p0 + (p1 - p0) * ((float)i / steps) : p0;
+		int x = (int)floor(p.x), y = (int)floor(p.y);
+		if (x >= 0 && x < width && y >= 0 && y < height) blend(x, y, color.r, color.g, color.b, color.a);
+	}
+}
+
+void SoftRenderBackend::circle(float x, float y, float radius) {
+	fillDisc(apply(glm::vec3(x, y, 0)), radius * scale(), color, false);
+}
+
+void SoftRenderBackend::sphere(const glm::vec3 & center, float radius) {
+	fillDisc(apply(center), radius * scale(), color, false);
+}
+
+//  A mesh's triangles, indexed or not, in the current color
+//
+void SoftRenderBackend::fillMesh(const ofMesh & mesh, const glm::vec3 & offset) {
+	const vector<glm::vec3> & v = mesh.getVertices();
+	const vector<ofIndexType> & indices = mesh.getIndices();
+	int n = indices.empty() ? v.size() : indices.size();
+	for (int i = 0; i + 2 < n; i += 3) {
+		int a = i, b = i + 1, c = i + 2;
+		if (!indices.empty()) {
+			a = indices[a];
+			b = indices[b];
+			c = indices[c];
+		}
+		fillTriangle(apply(v[a] + offset), apply(v[b] + offset), apply(v[c] + offset), color);
+	}
+}
+
+void SoftRenderBackend::mesh(const ofMesh & mesh) {
+	fillMesh(mesh, glm::vec3(0, 0, 0));
+}
+
+void SoftRenderBackend::text(const TextMesh & text, float x, float y) {
+	fillMesh(text.getMesh(), glm::vec3(x, y, 0));
+}
+
+//  Each particle's quad as a soft disc in its vertex color
+//
+void SoftRenderBackend::particles(const ParticleBatch & batch) {
+	float s = scale();
+	for (int i = 0; i < batch.size(); i++) {
+		const glm::vec3 *v = &batch.vertices[i * 6];
+		const ofFloatColor & c = batch.colors[i * 6];
+		ofColor color(c.r * 255, c.g * 255, c.b * 255, c.a * 255);
+		fillDisc(apply((v[0] + v[2]) * 0.5f), (v[2].x - v[0].x) * 0.5f * s, color, true);
+	}
+}
+
+//  FNV-1a
+//
+uint64_t SoftRenderBackend::checksum() const {
+	uint64_t hash = 14695981039346656037ULL;
+	for (int i = 0; i < buffer.size(); i++) {
+		hash ^= buffer[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+bool SoftRenderBackend::save(const string & path) const {
+	ofstream out(path.c_str(), ios::binary);
+	if (!out) return false;
+	out << "P6\n" << width << " " << height << "\n255\n";
+	for (int i = 0; i < buffer.size(); i += 4) out.write((const char *)&buffer[i], 3);
+	return (bool)out;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ofMain.h"
+#include "RenderBackend.h"
+
+//  A reference rasterizer: draws a RenderQueue into an RGBA buffer in
+//  memory with no GL at all, so the game's draw path can run, be timed and
+//  have its frames compared on machines without a GPU (lunarlander
+//  --render).
+//
+//  It aims to be simple and repeatable rather than to match the GPU pixel
+//  for pixel.  Each pixel is sampled once at its center (no antialiasing)
+//  and alpha blended over what's there.  Images are sampled at the nearest
+//  texel and tinted by their color.  Spheres are flat discs, as they are
+//  unlit on screen; particles are the soft discs of their texture.  Text is
+//  drawn as its filled glyph quads, since a font's glyph texture only
+//  exists on the GPU.  Triangle edges follow the top-left rule, so the two
+//  halves of a quad don't blend their shared edge twice.
+//
+class SoftRenderBackend : public RenderBackend {
+public:
+	SoftRenderBackend(int width = 0, int height = 0);
+	void allocate(int width, int height);
+	void clear(const ofColor & color);
+
+	void setColor(const ofColor & color) { this->color = color; }
+	void setTransform(const glm::mat4 *m);
+
+	void images(const ofImage & image, const ImageQuad *quads, int n);
+	void rect(float x, float y, float w, float h);
+	void triangle(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c);
+	void line(const glm::vec3 & a, const glm::vec3 & b);
+	void mesh(const ofMesh & mesh);
+	void circle(float x, float y, float radius);
+	void sphere(const glm::vec3 & center, float radius);
+	void text(const TextMesh & text, float x, float y);
+	void particles(const ParticleBatch & batch);
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	const unsigned char *getPixels() const { return buffer.empty() ? NULL : &buffer[0]; }
+
+	uint64_t checksum() const;					// of the pixels, to compare frames
+	bool save(const string & path) const;		// as a binary PPM (no alpha)
+
+private:
+	int width, height;
+	vector<unsigned char> buffer;		// RGBA, top row first
+	ofColor color;
+	glm::mat4 transform;
+	bool transformed;
+
+	glm::vec2 apply(const glm::vec3 & p) const;
+	float scale() const;
+	void blend(int x, int y, int r, int g, int b, int a);
+	void fillTriangle(const glm::vec2 & a, const glm::vec2 & b, const glm::vec2 & c, const ofColor & color);
+	void fillMesh(const ofMesh & mesh, const glm::vec3 & offset);
+	void fillDisc(const glm::vec2 & center, float radius, const ofColor & color, bool soft);
+};
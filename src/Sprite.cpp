@@ -0,0 +1,223 @@
+#include "Sprite.h"
+
+//
+// Basic Sprite Object
+//
+Sprite::Sprite() {
+	velocity = ofVec3f(0, 0, 0);
+	lifespan = -1;      // lifespan of -1 => immortal 
+	birthtime = 0;
+	bSelected = false;
+	image = NULL;
+	width = 20;
+	height = 20;
+}
+
+//  Set an image for the sprite. If you don't set one, a rectangle
+//  gets drawn.  The image is not copied, so it must outlive the sprite.
+//
+void Sprite::setImage(const ofImage & img) {
+	image = &img;
+	width = image->getWidth();
+	height = image->getHeight();
+}
+
+
+
+//  Add a Sprite to the Sprite System
+//
+void SpriteSystem::add(const Sprite & s) {
+	int i = sprites.create();
+	glm::vec3 pos = glm::vec3(s.getPosition().x, s.getPosition().y, 0);
+	sprites.position[i] = pos;
+	sprites.lastPosition[i] = pos;
+	sprites.velocity[i] = s.velocity;
+	sprites.birthtime[i] = s.birthtime;
+	sprites.lifespan[i] = s.lifespan;
+	sprites.image[i] = s.image;
+	sprites.dimensions[i] = glm::vec2(s.width, s.height);
+}
+
+// Remove a sprite from the sprite system. Note that this does not preserve
+// the order of the remaining sprites.
+//
+void SpriteSystem::remove(int i) {
+	sprites.remove(i);
+}
+
+void SpriteSystem::clear() {
+	sprites.clear();
+}
+
+
+//  Update the SpriteSystem by checking which sprites have exceeded their
+//  lifespan (and deleting).  Also the sprite is moved to it's next
+//  location based on velocity and direction.
+//
+//  now is the current time in ms, dt the time step in seconds.
+//
+void SpriteSystem::update(float now, float dt) {
+
+	if (sprites.size() == 0) return;
+
+	expireEntities(sprites, now);
+
+	//  Move sprites
+	//
+	integrateEntities(sprites, dt);
+}
+
+//  Render all the sprites (sprites don't fade, so the time doesn't matter)
+//
+void SpriteSystem::draw() {
+	drawEntities(sprites, 0);
+}
+
+// remove all sprites within a given dist of point, return number removed
+//
+int SpriteSystem::removeNear(ofVec3f point, float dist) {
+	int count = 0;
+	int i = 0;
+
+	while (i < sprites.size()) {
+		ofVec3f v = ofVec3f(sprites.position[i]) - point;
+		if (v.length() < dist) {
+			remove(i);
+			count++;
+		}
+		else i++;
+	}
+	return count;
+}
+
+// find all sprites that came within a given dist of a point moving from
+// "start" to "end" during this frame and add a collision event for each.
+// Both the point and the sprites are swept along their paths for the frame,
+// so hits are not missed when either moves further than "dist" in a single
+// frame.  Nothing is modified - the events are handled later.
+//
+void SpriteSystem::findSwept(const glm::vec3 & start, const glm::vec3 & end, float dist, short system, short hitBy, CollisionQueue & queue) const {
+	for (int i = 0; i < sprites.size(); i++) {
+		if (sweptCircleHit(start, end, sprites.lastPosition[i], sprites.position[i], dist))
+			queue.add(system, hitBy, i, sprites.position[i]);
+	}
+}
+
+// remove the sprites at the given indices (sorted, ascending)
+//
+void SpriteSystem::removeSorted(const vector<int> & indices) {
+	sprites.removeSorted(indices);
+}
+
+//  Create a new Emitter - needs a SpriteSystem
+//
+Emitter::Emitter(SpriteSystem* spriteSys) {
+	sys = spriteSys;
+	lifespan = 3000;    // milliseconds
+	started = false;
+
+	lastSpawned = 0;
+	rate = 1;    // sprites/sec
+	haveChildImage = false;
+	haveImage = false;
+	velocity = ofVec3f(100, 100, 0);
+	drawable = true;
+	width = 50;
+	height = 50;
+	childWidth = 10;
+	childHeight = 10;
+}
+
+//  Draw the Emitter 
+void Emitter::draw() {
+	// draw sprite system
+	sys->draw();
+}
+
+//shoot function for the turret.  Returns true if a shot was fired (the
+//turret can only fire "rate" times a second).  now is the time in ms.
+//
+bool Emitter::shoot(float now) {
+	if ((now - lastSpawned) > (1000.0 / rate)) {
+		// spawn a new sprite
+		Sprite sprite;
+		if (haveChildImage) sprite.setImage(childImage);
+		sprite.velocity = velocity;
+		sprite.lifespan = lifespan;
+		sprite.setPosition(position);
+		
+		sprite.birthtime = now;
+		sys->add(sprite);
+		lastSpawned = now;
+		return true;
+	}
+	return false;
+}
+
+void Emitter::launch(float now, float dt, Random & random) {
+	if (!started) return;
+
+	if ((now - lastSpawned) > (1000.0 / rate)) {
+		// spawn a new sprite
+		Sprite sprite;
+		if (haveChildImage) sprite.setImage(childImage);
+		sprite.velocity = ofVec3f(random.range(-35,35),random.range(500,1000),velocity.z);
+		sprite.lifespan = lifespan;
+		sprite.setPosition(position);
+		sprite.birthtime = now;
+		sys->add(sprite);
+		lastSpawned = now;
+	}
+	sys->update(now, dt);
+}
+
+//  Update the Emitter. If it has been started, spawn new sprites with
+//  initial velocity, lifespan, birthtime.
+//
+void Emitter::update(float now, float dt) {
+	if (!started) return;
+
+
+	sys->update(now, dt);
+}
+
+// Start/Stop the emitter.
+//
+void Emitter::start(float now) {
+	if (!started) {
+		started = true;
+		lastSpawned = now;
+	}
+}
+
+void Emitter::stop() {
+	started = false;
+}
+
+
+void Emitter::setLifespan(float life) {
+	lifespan = life;
+}
+
+void Emitter::setVelocity(ofVec3f v) {
+	velocity = v;
+}
+
+void Emitter::setChildImage(ofImage img) {
+	childImage = img;
+	haveChildImage = true;
+	childWidth = img.getWidth();
+	childHeight = img.getHeight();
+}
+
+void Emitter::setImage(ofImage img) {
+	image = img;
+}
+
+float Emitter::maxDistPerFrame(float dt) {
+	return  velocity.length() * dt;
+}
+
+void Emitter::setRate(float r) {
+	rate = r;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ParticleEmitter.h"
+#include "Collision.h"
+#include "TransformObject.h"
+#include "EntityStore.h"
+#include "Random.h"
+
+// This is a base object that all drawable object inherit from
+// It is possible this will be replaced by ofNode when we move to 3D
+//
+class BaseObject : public TransformObject {
+public:
+	BaseObject() {}
+};
+
+//  General Sprite class  (similar to a Particle)
+//
+//  Describes a sprite to add to a SpriteSystem.  Once added, the sprite's
+//  data lives in the system's EntityStore and is moved, expired and drawn by
+//  the same entity systems as particles (see EntityStore.h).
+//
+class Sprite : public BaseObject {
+public:
+	Sprite();
+	void setImage(const ofImage &);
+	ofVec3f velocity; // in pixels/sec
+	const ofImage *image;	// not owned, NULL => draw a box
+	float birthtime; // elapsed time in ms
+	float lifespan;  //  time in ms
+	float width, height;  
+};
+
+//  Manages all Sprites in a system.  You can create multiple systems
+//
+class SpriteSystem {
+public:
+	void add(const Sprite &);
+	void remove(int);
+	void clear();
+	void update(float now, float dt);
+	void draw();
+	int size() const { return sprites.size(); }
+	EntityStore sprites;
+	int removeNear(ofVec3f point, float dist);
+	void findSwept(const glm::vec3 & start, const glm::vec3 & end, float dist, short system, short hitBy, CollisionQueue & queue) const;
+	void removeSorted(const vector<int> & indices);
+	//glm::vec3 curveEval(float x, float scale, float cycles);
+	ParticleEmitter emitter;
+	short layer = LayerInvader;		// collision layer (CollisionLayer)
+	float radius = 0;				// collision radius of each sprite
+};
+
+//  General purpose Emitter class for emitting sprites
+//  This works similar to a Particle emitter
+//
+class Emitter : public BaseObject {
+public:
+	//TriangleShape triangleRef;
+	Emitter(SpriteSystem*);
+	virtual void move() {};
+	glm::vec3 heading;
+	void draw();
+	void start(float now);
+	void stop();
+	void setLifespan(float);    // in milliseconds
+	void setVelocity(ofVec3f);  // pixel/sec
+	void setChildImage(ofImage);
+	void setChildSize(float w, float h) { childWidth = w; childHeight = h; }
+	void setImage(ofImage);
+	void setRate(float);
+	float maxDistPerFrame(float dt);
+	void update(float now, float dt);
+	SpriteSystem* sys;
+	float rate;
+	ofVec3f velocity;
+	float lifespan;
+	bool started;
+	float lastSpawned;
+	ofImage childImage;
+	ofImage image;
+	bool drawable;
+	bool haveChildImage;
+	bool haveImage;
+	float width, height;
+	float childWidth, childHeight;
+	void launch(float now, float dt, Random & random);
+	bool shoot(float now);
+};
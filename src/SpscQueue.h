@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+
+//  Bounded lock free queue for one producer thread and one consumer
+//  thread.  push() fails instead of waiting when the queue is full.
+//  capacity must be a power of two.
+//
+template <typename T, int capacity>
+class SpscQueue {
+public:
+	SpscQueue() : head(0), tail(0) {}
+
+	// producer
+	//
+	bool push(const T & item) {
+		unsigned t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) == capacity) return false;
+		items[t & (capacity - 1)] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer
+	//
+	bool pop(T & item) {
+		unsigned h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return false;
+		item = items[h & (capacity - 1)];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	T items[capacity];
+	std::atomic<unsigned> head;		// next to pop (consumer)
+	std::atomic<unsigned> tail;		// next to push (producer)
+};
@@ -0,0 +1,200 @@
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+static uint64_t nowNanos() {
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool shares(const std::vector<int> & a, const std::vector<int> & b) {
+	for (int i = 0; i < a.size(); i++) {
+		if (std::find(b.begin(), b.end(), a[i]) != b.end()) return true;
+	}
+	return false;
+}
+
+TaskGraph::TaskGraph() : remaining(0) {
+	pool = NULL;
+	profiler = NULL;
+	runs = 0;
+	timed = false;
+}
+
+TaskGraph::~TaskGraph() {
+	clear();
+}
+
+//  Id of the named resource, registering it on first use
+//
+int TaskGraph::resource(const std::string & name) {
+	for (int i = 0; i < resources.size(); i++) {
+		if (resources[i] == name) return i;
+	}
+	resources.push_back(name);
+	return resources.size() - 1;
+}
+
+int TaskGraph::add(const std::string & name, std::function<void()> fn,
+	const std::vector<int> & reads, const std::vector<int> & writes) {
+	Task *task = new Task();
+	task->name = name;
+	task->profileName = Profiler::intern(name);
+	task->fn = fn;
+	task->reads = reads;
+	task->writes = writes;
+	task->graph = this;
+
+	int id = tasks.size();
+	for (int i = 0; i < id; i++) {
+		Task *earlier = tasks[i];
+		if (shares(earlier->writes, reads) || shares(earlier->writes, writes) || shares(earlier->reads, writes)) {
+			earlier->successors.push_back(id);
+			task->predecessors.push_back(i);
+		}
+	}
+	tasks.push_back(task);
+	return id;
+}
+
+void TaskGraph::clear() {
+	for (int i = 0; i < tasks.size(); i++) delete tasks[i];
+	tasks.clear();
+	resources.clear();
+}
+
+void TaskGraph::job(void *arg) {
+	Task *task = (Task *)arg;
+	task->graph->execute(task);
+}
+
+uint64_t TaskGraph::clock() const {
+	return profiler ? profiler->now() : nowNanos();
+}
+
+//  Run a task, timing it if this run is timed
+//
+void TaskGraph::call(Task *task) {
+	if (!timed) {
+		task->fn();
+		return;
+	}
+	task->thread = ThreadPool::worker();
+	task->start = clock();
+	task->fn();
+	task->end = clock();
+	task->duration = task->end - task->start;
+}
+
+//  Run a task, then hand any successors it was the last to wait for to the
+//  pool
+//
+void TaskGraph::execute(Task *task) {
+	call(task);
+
+	for (int i = 0; i < task->successors.size(); i++) {
+		Task *next = tasks[task->successors[i]];
+		if (next->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pool->submit(job, next);
+	}
+	remaining.fetch_sub(1, std::memory_order_release);
+}
+
+//  Run every task once, returning when all are done.  The calling thread
+//  runs tasks too while it waits.
+//
+void TaskGraph::run(ThreadPool *pool) {
+	profiler = Profiler::current();
+	timed = runs++ % timingInterval == 0 || profiler;
+
+	if (!pool || pool->size() == 0) {
+		for (int i = 0; i < tasks.size(); i++) call(tasks[i]);
+	}
+	else runParallel(pool);
+
+	// back on the calling thread with every task done, so the profiler can
+	// be given the samples
+	//
+	if (profiler) {
+		for (int i = 0; i < tasks.size(); i++) {
+			profiler->add(tasks[i]->profileName, tasks[i]->start, tasks[i]->end, tasks[i]->thread);
+		}
+	}
+}
+
+void TaskGraph::runParallel(ThreadPool *pool) {
+	this->pool = pool;
+	remaining.store(tasks.size(), std::memory_order_relaxed);
+	for (int i = 0; i < tasks.size(); i++) {
+		tasks[i]->pending.store(tasks[i]->predecessors.size(), std::memory_order_relaxed);
+	}
+	for (int i = 0; i < tasks.size(); i++) {
+		if (tasks[i]->predecessors.empty()) pool->submit(job, tasks[i]);
+	}
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		if (!pool->runOne()) std::this_thread::yield();
+	}
+}
+
+//  The chain of dependent tasks that took longest in the last run: no
+//  amount of threads makes a run faster than this.  Tasks are added in a
+//  valid order, so one pass in that order finds it.
+//
+std::vector<int> TaskGraph::criticalPath(double *ms) const {
+	int n = tasks.size();
+	std::vector<uint64_t> finish(n, 0);
+	std::vector<int> via(n, -1);
+	int last = -1;
+	for (int i = 0; i < n; i++) {
+		uint64_t start = 0;
+		for (int k = 0; k < tasks[i]->predecessors.size(); k++) {
+			int p = tasks[i]->predecessors[k];
+			if (finish[p] > start) {
+				start = finish[p];
+				via[i] = p;
+			}
+		}
+		finish[i] = start + tasks[i]->duration;
+		if (last < 0 || finish[i] > finish[last]) last = i;
+	}
+
+	std::vector<int> path;
+	for (int i = last; i >= 0; i = via[i]) path.push_back(i);
+	std::reverse(path.begin(), path.end());
+	if (ms) *ms = last >= 0 ? finish[last] / 1e6 : 0;
+	return path;
+}
+
+//  Graphviz: tasks labelled with their last duration and the resources
+//  they write, the critical path in red
+//
+void TaskGraph::writeDot(std::ostream & out) const {
+	std::vector<int> path = criticalPath();
+	std::vector<bool> critical(tasks.size(), false);
+	for (int i = 0; i < path.size(); i++) critical[path[i]] = true;
+
+	out << "digraph tasks {" << std::endl;
+	out << "  node [shape=box, fontname=\"Helvetica\"];" << std::endl;
+	for (int i = 0; i < tasks.size(); i++) {
+		const Task *t = tasks[i];
+		out << "  t" << i << " [label=\"" << t->name << "\\n" << t->duration / 1000.0 << " us";
+		if (!t->writes.empty()) {
+			out << "\\nwrites:";
+			for (int k = 0; k < t->writes.size(); k++) out << " " << resources[t->writes[k]];
+		}
+		out << "\"" << (critical[i] ? ", color=red" : "") << "];" << std::endl;
+	}
+	for (int i = 0; i < tasks.size(); i++) {
+		for (int k = 0; k < tasks[i]->successors.size(); k++) {
+			int s = tasks[i]->successors[k];
+			bool onPath = false;
+			for (int p = 0; p + 1 < path.size(); p++) {
+				if (path[p] == i && path[p + 1] == s) onPath = true;
+			}
+			out << "  t" << i << " -> t" << s << (onPath ? " [color=red]" : "") << ";" << std::endl;
+		}
+	}
+	out << "}" << std::endl;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <ostream>
+#include <stdint.h>
+
+class ThreadPool;
+class Profiler;
+
+//  Runs a fixed set of tasks, in parallel where their data allows.
+//
+//  Each task declares the resources (named pieces of state) it reads and
+//  writes.  A task depends on every earlier task it conflicts with: one
+//  that writes something it reads or writes, or reads something it writes.
+//  So tasks added in the order they would run serially keep exactly that
+//  behavior, while independent ones may run at the same time on a thread
+//  pool.  Without a pool the tasks just run in the order they were added.
+//
+//  The graph is built once and run every step.  Every timingInterval'th run
+//  records how long each task took (reading the clock around every task
+//  every run would cost as much as the smaller tasks), which
+//  criticalPath() and writeDot() report.
+//
+//  If the thread calling run() has a profiler, every run is timed and each
+//  task is added to it as a sample under the task's name, whichever thread
+//  ran it.
+//
+class TaskGraph {
+public:
+	TaskGraph();
+	~TaskGraph();
+	TaskGraph(const TaskGraph &) = delete;
+	TaskGraph & operator=(const TaskGraph &) = delete;
+
+	int resource(const std::string & name);
+	int add(const std::string & name, std::function<void()> fn,
+		const std::vector<int> & reads, const std::vector<int> & writes);
+	void clear();
+	void run(ThreadPool *pool);
+
+	std::vector<int> criticalPath(double *ms = NULL) const;
+	void writeDot(std::ostream & out) const;
+	int size() const { return tasks.size(); }
+	const std::string & name(int task) const { return tasks[task]->name; }
+
+private:
+	struct Task {
+		std::string name;
+		const char *profileName;		// name, interned for the profiler
+		std::function<void()> fn;
+		std::vector<int> reads, writes;
+		std::vector<int> successors;
+		std::vector<int> predecessors;
+		std::atomic<int> pending;		// predecessors yet to finish this run
+		uint64_t duration;				// ns, last run
+		uint64_t start, end;			// last timed run, on the profiler's clock if there is one
+		int thread;						// pool worker that ran it (0 = the calling thread)
+		TaskGraph *graph;
+		Task() : pending(0), duration(0), start(0), end(0), thread(0), graph(NULL) {}
+	};
+	std::vector<Task *> tasks;
+	std::vector<std::string> resources;
+	std::atomic<int> remaining;		// tasks yet to finish this run
+	ThreadPool *pool;				// pool for the current run
+	Profiler *profiler;				// the calling thread's, for the current run
+	unsigned long runs;
+	bool timed;						// time the tasks in the current run
+	static const int timingInterval = 16;
+
+	void runParallel(ThreadPool *pool);
+	void call(Task *task);
+	uint64_t clock() const;
+	void execute(Task *task);
+	static void job(void *task);
+};
@@ -0,0 +1,212 @@
+#include "Telemetry.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TelemetryRing::TelemetryRing() {
+	header = 0;
+	slots = 0;
+	size = 0;
+	owner = false;
+#ifdef _WIN32
+	mapping = 0;
+#else
+	segmentId = 0;
+#endif
+}
+
+TelemetryRing::~TelemetryRing() {
+	close();
+}
+
+//  Map a segment of the given size, creating it if asked.  Returns the
+//  address or 0, and (POSIX) the segment's identity in id.
+//
+#ifdef _WIN32
+static void *mapSegment(const std::string & name, size_t size, bool create, void **mapping) {
+	if (create) {
+		*mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+			0, (DWORD)size, name.c_str());
+	}
+	else {
+		*mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+	}
+	if (!*mapping) return 0;
+	void *p = MapViewOfFile(*mapping, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	if (!p) {
+		CloseHandle(*mapping);
+		*mapping = 0;
+	}
+	return p;
+}
+#else
+static uint64_t fileId(int fd) {
+	struct stat st;
+	if (fstat(fd, &st) != 0) return 0;
+	return ((uint64_t)st.st_dev << 32) ^ (uint64_t)st.st_ino;
+}
+
+static void *mapSegment(const std::string & name, size_t size, bool create, uint64_t *id = 0) {
+	int fd = create ? shm_open(name.c_str(), O_RDWR | O_CREAT, 0644) : shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) return 0;
+	if (id) *id = fileId(fd);
+	if (create && ftruncate(fd, size) != 0) {
+		::close(fd);
+		return 0;
+	}
+	void *p = mmap(NULL, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	return p == MAP_FAILED ? 0 : p;
+}
+#endif
+
+static size_t segmentSize(int capacity) {
+	return sizeof(TelemetryHeader) + capacity * sizeof(TelemetrySlot);
+}
+
+//  Create (or take over) the segment and publish an empty ring
+//
+bool TelemetryRing::create(const std::string & name, int capacity) {
+	close();
+	size = segmentSize(capacity);
+#ifdef _WIN32
+	void *p = mapSegment(name, size, true, &mapping);
+#else
+	void *p = mapSegment(name, size, true);
+#endif
+	if (!p) return false;
+
+	memset(p, 0, size);
+	header = (TelemetryHeader *)p;
+	slots = (TelemetrySlot *)(header + 1);
+	header->recordSize = sizeof(TelemetryRecord);
+	header->capacity = capacity;
+	header->version = telemetryVersion;
+	header->written.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = telemetryMagic;		// last, so readers see a complete header
+	this->name = name;
+	owner = true;
+	return true;
+}
+
+//  Map an existing segment read only, checking that its layout matches ours
+//
+bool TelemetryRing::open(const std::string & name) {
+	close();
+
+	// map just the header first to learn the capacity
+	//
+#ifdef _WIN32
+	void *p = mapSegment(name, sizeof(TelemetryHeader), false, &mapping);
+#else
+	void *p = mapSegment(name, sizeof(TelemetryHeader), false);
+#endif
+	if (!p) return false;
+	TelemetryHeader *h = (TelemetryHeader *)p;
+	bool valid = h->magic == telemetryMagic && h->version == telemetryVersion &&
+		h->recordSize == sizeof(TelemetryRecord);
+	int capacity = h->capacity;
+#ifdef _WIN32
+	UnmapViewOfFile(p);
+	CloseHandle(mapping);
+	mapping = 0;
+#else
+	munmap(p, sizeof(TelemetryHeader));
+#endif
+	if (!valid) return false;
+
+	size = segmentSize(capacity);
+#ifdef _WIN32
+	p = mapSegment(name, size, false, &mapping);
+#else
+	p = mapSegment(name, size, false, &segmentId);
+#endif
+	if (!p) return false;
+	header = (TelemetryHeader *)p;
+	slots = (TelemetrySlot *)(header + 1);
+	this->name = name;
+	owner = false;
+	return true;
+}
+
+void TelemetryRing::close() {
+	if (!header) return;
+#ifdef _WIN32
+	UnmapViewOfFile(header);
+	CloseHandle(mapping);
+	mapping = 0;
+#else
+	munmap(header, size);
+	if (owner) shm_unlink(name.c_str());
+#endif
+	header = 0;
+	slots = 0;
+	owner = false;
+}
+
+//  A reader's mapping keeps the segment it opened alive after the writer
+//  unlinks it, so a new run of the game creates a different segment under
+//  the same name.  On Windows the named mapping lives as long as any view
+//  of it, so a new run reuses (and resets) the one already open instead.
+//
+bool TelemetryRing::replaced() const {
+#ifdef _WIN32
+	return false;
+#else
+	if (!header || owner) return false;
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) return true;
+	uint64_t id = fileId(fd);
+	::close(fd);
+	return id != segmentId;
+#endif
+}
+
+//  Writer: copy the record into the next slot
+//
+void TelemetryRing::publish(const TelemetryRecord & record) {
+	if (!header) return;
+	uint64_t n = header->written.load(std::memory_order_relaxed);
+	TelemetrySlot & slot = slots[n % header->capacity];
+
+	uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+	slot.seq.store(seq + 1, std::memory_order_relaxed);		// odd: being written
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.record = record;
+	slot.seq.store(seq + 2, std::memory_order_release);		// even: complete
+	header->written.store(n + 1, std::memory_order_release);
+}
+
+uint64_t TelemetryRing::written() const {
+	return header ? header->written.load(std::memory_order_acquire) : 0;
+}
+
+//  Reader: copy record number "index" (0 based, since the ring was created).
+//  Fails if it has been overwritten or is being written; callers that fall
+//  more than a ring behind should skip ahead to written() - capacity.
+//
+bool TelemetryRing::read(uint64_t index, TelemetryRecord & record) const {
+	if (!header) return false;
+	uint64_t n = written();
+	if (index >= n || n - index > header->capacity) return false;
+
+	const TelemetrySlot & slot = slots[index % header->capacity];
+	uint32_t before = slot.seq.load(std::memory_order_acquire);
+	if (before & 1) return false;
+	memcpy(&record, (const void *)&slot.record, sizeof(record));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint32_t after = slot.seq.load(std::memory_order_relaxed);
+	if (before != after) return false;
+
+	// the slot may have been reused for a newer record while we copied
+	//
+	return written() - index <= header->capacity;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+//  Shared memory telemetry ring.
+//
+//  The app publishes one fixed layout TelemetryRecord per frame into a ring
+//  of records in a named shared memory segment, and external monitors (see
+//  tools/telemetry_tail.cpp) map the same segment read only and tail it.
+//  Publishing is a copy into the mapping, with no locks, system calls or
+//  allocation, so readers never slow the game loop down.
+//
+//  Each slot is guarded by a sequence counter (a seqlock): the writer makes
+//  it odd while it writes the slot and even again when done, and a reader
+//  keeps a copy only if it saw the same even count before and after.
+//
+//  Only plain fixed size types are used so the layout is the same for any
+//  compiler reading it; bump telemetryVersion when it changes.
+//
+//  This header doesn't include ofMain.h so the tools can use it.
+//
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+const uint32_t telemetryMagic = 0x4c4e4454;		// "TDNL"
+const uint32_t telemetryVersion = 1;
+const int telemetryMaxSystems = 8;
+
+struct TelemetryRecord {
+	uint64_t frame;				// app frame number
+	uint64_t tick;				// world ticks so far
+	float frameTime;			// ms
+	float fps;
+	uint32_t particleSystems;	// entries used in liveParticles
+	uint32_t spriteSystems;		// entries used in liveSprites
+	uint32_t liveParticles[telemetryMaxSystems];
+	uint32_t liveSprites[telemetryMaxSystems];
+	uint32_t collisions;		// collision events this frame
+	uint32_t spawned;			// particles and sprites created this frame
+	uint32_t expired;			// particles and sprites that aged out this frame
+	int32_t score;
+};
+
+struct TelemetrySlot {
+	std::atomic<uint32_t> seq;
+	uint32_t pad;
+	TelemetryRecord record;
+};
+
+struct TelemetryHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t recordSize;		// sizeof(TelemetryRecord)
+	uint32_t capacity;			// slots in the ring
+	std::atomic<uint64_t> written;	// records published so far
+};
+
+class TelemetryRing {
+public:
+	TelemetryRing();
+	~TelemetryRing();
+
+	bool create(const std::string & name, int capacity = 1024);	// writer
+	bool open(const std::string & name);						// reader
+	void close();
+	bool isOpen() const { return header != 0; }
+	bool replaced() const;			// reader: the name no longer refers to the segment mapped
+
+	void publish(const TelemetryRecord & record);
+	uint64_t written() const;
+	uint32_t capacity() const { return header ? header->capacity : 0; }
+	bool read(uint64_t index, TelemetryRecord & record) const;
+
+private:
+	TelemetryHeader *header;
+	TelemetrySlot *slots;
+	size_t size;
+	std::string name;
+	bool owner;
+#ifdef _WIN32
+	void *mapping;
+#else
+	uint64_t segmentId;			// device and inode of the mapped segment
+#endif
+};
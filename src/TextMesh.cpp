@@ -0,0 +1,49 @@
+#include "TextMesh.h"
+#include <string.h>
+
+unsigned long TextMesh::rebuilds = 0;
+
+TextMesh::TextMesh() {
+	font = NULL;
+	prefix = NULL;
+	value = 0;
+}
+
+void TextMesh::setText(const ofTrueTypeFont *font, const char *text) {
+	if (font == this->font && !prefix && this->text == text) return;
+	prefix = NULL;
+	this->text = text;
+	rebuild(font);
+}
+
+void TextMesh::setNumber(const ofTrueTypeFont *font, const char *prefix, int value) {
+	if (font == this->font && prefix == this->prefix && value == this->value) return;
+	char line[64];
+	snprintf(line, sizeof(line), "%s%d", prefix, value);
+	this->prefix = prefix;
+	this->value = value;
+	text = line;
+	rebuild(font);
+}
+
+//  Called once the text is known to have changed
+//
+void TextMesh::rebuild(const ofTrueTypeFont *font) {
+	this->font = font;
+	rebuilds++;
+	if (font) mesh = font->getStringMesh(text, 0, 0);
+	else mesh.clear();
+}
+
+//  As drawString() does, with the font's glyph texture bound
+//
+void TextMesh::draw(float x, float y) const {
+	if (!font) return;
+	const ofTexture & texture = font->getFontTexture();
+	texture.bind();
+	ofPushMatrix();
+	ofTranslate(x, y);
+	mesh.draw();
+	ofPopMatrix();
+	texture.unbind();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ofMain.h"
+
+//  One line of text drawn from a cached glyph mesh.
+//
+//  ofTrueTypeFont::drawString() lays out and builds a new mesh for the
+//  string every call.  A TextMesh keeps the mesh and only rebuilds it when
+//  the font or text changes, so text that changes rarely (the HUD's score
+//  and time, its messages) costs one draw call a frame.  setNumber()
+//  compares the number rather than the formatted string, so an unchanged
+//  value doesn't format (or allocate) anything.
+//
+//  rebuilds counts the meshes built by all TextMeshes, for the profiler
+//  overlay.  With a NULL font (headless runs, which can't load fonts)
+//  changes are still noticed and counted but no mesh is built, so
+//  --render can check the HUD only rebuilds when its text changes.
+//
+class TextMesh {
+public:
+	TextMesh();
+	void setText(const ofTrueTypeFont *font, const char *text);
+	void setNumber(const ofTrueTypeFont *font, const char *prefix, int value);
+	void draw(float x, float y) const;
+	const ofTrueTypeFont *getFont() const { return font; }
+	const ofMesh & getMesh() const { return mesh; }		// glyph quads at 0, 0
+
+	static unsigned long rebuilds;
+
+private:
+	const ofTrueTypeFont *font;
+	string text;
+	const char *prefix;			// setNumber()'s, NULL after setText()
+	int value;
+	ofMesh mesh;
+
+	void rebuild(const ofTrueTypeFont *font);
+};
@@ -0,0 +1,60 @@
+#include "ThreadPool.h"
+
+static thread_local int workerIndex = 0;
+
+ThreadPool::ThreadPool(int threads) {
+	stopping = false;
+	jobs.reserve(64);
+	for (int i = 0; i < threads; i++) {
+		workers.push_back(std::thread(&ThreadPool::work, this, i + 1));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (int i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+void ThreadPool::submit(JobFunction fn, void *arg) {
+	Job job = { fn, arg };
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		jobs.push_back(job);
+	}
+	wake.notify_one();
+}
+
+bool ThreadPool::runOne() {
+	Job job;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (jobs.empty()) return false;
+		job = jobs.back();
+		jobs.pop_back();
+	}
+	job.fn(job.arg);
+	return true;
+}
+
+int ThreadPool::worker() {
+	return workerIndex;
+}
+
+void ThreadPool::work(int index) {
+	workerIndex = index;
+	for (;;) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wake.wait(guard, [this] { return stopping || !jobs.empty(); });
+			if (jobs.empty()) return;		// stopping
+			job = jobs.back();
+			jobs.pop_back();
+		}
+		job.fn(job.arg);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//  Fixed set of worker threads running submitted jobs.
+//
+//  A job is a plain function and argument, so submitting one doesn't
+//  allocate.  The thread waiting on a batch of jobs can help with
+//  runOne() instead of blocking.
+//
+class ThreadPool {
+public:
+	typedef void (*JobFunction)(void *arg);
+
+	ThreadPool(int threads);
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool & operator=(const ThreadPool &) = delete;
+
+	void submit(JobFunction fn, void *arg);
+	bool runOne();			// run a queued job on this thread, false if none
+	int size() const { return workers.size(); }
+	static int worker();	// 1.. on a pool's worker threads, 0 elsewhere
+
+private:
+	struct Job {
+		JobFunction fn;
+		void *arg;
+	};
+	std::vector<std::thread> workers;
+	std::vector<Job> jobs;		// used as a stack
+	std::mutex lock;
+	std::condition_variable wake;
+	bool stopping;
+
+	void work(int index);
+};
@@ -1,14 +1,55 @@
-#pragma once
 #include "TransformObject.h"
 
 //  Base class for any object that needs a transform.
 //
 TransformObject::TransformObject() {
-	position = ofVec3f(0, 0, 0);
-	scale = ofVec3f(1, 1, 1);
+	position = glm::vec3(0, 0, 0);
+	scale = glm::vec3(1, 1, 1);
 	rotation = 0;
+	bSelected = false;
+	matrix = glm::mat4(1.0);
+	heading = glm::vec3(0, -1, 0);
+	matrixDirty = false;
+	headingDirty = false;
+	version = 0;
 }
 
-void TransformObject::setPosition(const ofVec3f & pos) {
+void TransformObject::setPosition(const glm::vec3 & pos) {
 	position = pos;
+	changed();
+}
+
+void TransformObject::setRotation(float r) {
+	rotation = r;
+	headingDirty = true;
+	changed();
+}
+
+void TransformObject::setScale(const glm::vec3 & s) {
+	scale = s;
+	changed();
+}
+
+//  World matrix:  translate * rotate (about z) * scale
+//
+const glm::mat4 & TransformObject::getMatrix() {
+	if (matrixDirty) {
+		glm::mat4 translate = glm::translate(glm::mat4(1.0), position);
+		glm::mat4 rot = glm::rotate(glm::mat4(1.0), glm::radians(rotation), glm::vec3(0, 0, 1));
+		glm::mat4 scl = glm::scale(glm::mat4(1.0), scale);
+		matrix = translate * rot * scl;
+		matrixDirty = false;
+	}
+	return matrix;
+}
+
+//  Unit vector the object is facing.  A rotation of 0 faces up the screen.
+//
+const glm::vec3 & TransformObject::getHeading() {
+	if (headingDirty) {
+		float r = glm::radians(rotation + 270);
+		heading = glm::vec3(cos(r), sin(r), 0);
+		headingDirty = false;
+	}
+	return heading;
 }
@@ -6,11 +6,38 @@
 
 //  Base class for any object that needs a transform.
 //
+//  The world matrix and heading are cached and only rebuilt when position,
+//  rotation or scale have changed since they were last asked for, so they
+//  can be read as often as needed each frame.  Change the transform through
+//  the setters so the cache is invalidated.
+//
 class TransformObject {
 public:
 	TransformObject();
-	ofVec3f position, scale;
-	float	rotation;
+	virtual ~TransformObject() {}
+	void setPosition(const glm::vec3 &);
+	void setRotation(float);		// degrees
+	void setScale(const glm::vec3 &);
+	const glm::vec3 & getPosition() const { return position; }
+	float getRotation() const { return rotation; }
+	const glm::vec3 & getScale() const { return scale; }
+	const glm::mat4 & getMatrix();
+	const glm::vec3 & getHeading();
+
+	// incremented every time the transform changes, so other cached
+	// data derived from it can tell when it is stale
+	//
+	unsigned int getVersion() const { return version; }
+
 	bool	bSelected;
-	void setPosition(const ofVec3f &);
-};
\ No newline at end of file
+protected:
+	glm::vec3 position, scale;
+	float	rotation;
+private:
+	glm::mat4 matrix;
+	glm::vec3 heading;
+	bool	matrixDirty;
+	bool	headingDirty;
+	unsigned int version;
+	void	changed() { matrixDirty = true; version++; }
+};
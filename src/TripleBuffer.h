@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+
+//  Lock free triple buffer for handing the latest value from one producer
+//  thread to one consumer thread.
+//
+//  The producer fills writeBuffer() and publish()es it; the consumer's
+//  read() returns the most recently published value and keeps returning it
+//  until a newer one is published.  Neither side ever waits: the producer
+//  always has a buffer of its own to write into, and a value the consumer
+//  didn't get to in time is simply replaced by the next.  Buffers are
+//  reused, so a T that keeps its storage across assignments (vectors)
+//  stops allocating once all three have grown.
+//
+template <typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() : middle(2), back(0), front(1) {}
+
+	// producer
+	//
+	T & writeBuffer() { return buffers[back]; }
+	void publish() {
+		back = middle.exchange(back | fresh, std::memory_order_acq_rel) & index;
+	}
+
+	// consumer
+	//
+	const T & read() {
+		if (middle.load(std::memory_order_acquire) & fresh) {
+			front = middle.exchange(front, std::memory_order_acq_rel) & index;
+		}
+		return buffers[front];
+	}
+
+private:
+	static const int index = 3;		// low bits of middle: the buffer it holds
+	static const int fresh = 4;		// set when middle holds an unread value
+	T buffers[3];
+	std::atomic<int> middle;		// buffer being handed over
+	int back;						// producer's buffer
+	int front;						// consumer's buffer
+};
@@ -1,13 +1,82 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "Headless.h"
+#include "BatchRunner.h"
+#include "Benchmark.h"
+#include "AssetPacker.h"
 
 //========================================================================
-int main( ){
+//  Usage:  lunarlander [--headless [ticks [--record file]] [--max-allocs n] |
+//                       --batch [worlds [rounds]] |
+//                       --bench [csv | json [maxN]] |
+//                       --render [frames [file]] |
+//                       --record file | --replay file [--headless] |
+//                       --pack [file]]
+//
+//  --headless runs the simulation without a window or sound as fast as
+//  possible and reports ticks/second (default 1,000,000 ticks).  In builds
+//  with LANDER_TRACK_ALLOCS it also counts heap allocations and exits with
+//  code 2 if there are more than n per tick after warm up (default 0).
+//
+//  --batch plays many independent worlds across all cores (default 1000
+//  worlds x 10 rounds) and reports rounds/second and the score distribution.
+//
+//  --bench times the simulation hot paths at 10^2 .. maxN objects (default
+//  10^6) and writes the results to stdout as CSV (default) or JSON.
+//
+//  --render draws the headless run with the software rasterizer (default
+//  600 frames), reports the draw path's time per frame and saves the last
+//  frame to file, a PPM golden frame.  It exits 2 if the HUD's text meshes
+//  were rebuilt more often than the text changed.
+//
+//  --record saves the session's input and random seed to file on exit;
+//  --replay plays it back tick for tick, in the window or, with --headless,
+//  as fast as possible for timing.
+//
+//  --pack decodes the images and sounds under data/ into an asset pack
+//  (default data/assets.pack) that the game maps at startup instead.
+//
+int main(int argc, char *argv[]){
+	if (argc > 1 && string(argv[1]) == "--headless") {
+		long ticks = argc > 2 ? atol(argv[2]) : 1000000;
+		string record = argc > 4 && string(argv[3]) == "--record" ? argv[4] : "";
+		double maxAllocs = 0;
+		for (int i = 2; i + 1 < argc; i++) {
+			if (string(argv[i]) == "--max-allocs") maxAllocs = atof(argv[i + 1]);
+		}
+		return runHeadless(ticks, record, maxAllocs);
+	}
+	if (argc > 1 && string(argv[1]) == "--render") {
+		long frames = argc > 2 ? atol(argv[2]) : 600;
+		return runRender(frames, argc > 3 ? argv[3] : "");
+	}
+	if (argc > 1 && string(argv[1]) == "--batch") {
+		int worlds = argc > 2 ? atoi(argv[2]) : 1000;
+		int rounds = argc > 3 ? atoi(argv[3]) : 10;
+		return runBatch(worlds, rounds);
+	}
+
+	if (argc > 1 && string(argv[1]) == "--bench") {
+		string format = argc > 2 ? argv[2] : "csv";
+		int maxN = argc > 3 ? atoi(argv[3]) : 1000000;
+		return runBenchmarks(format, maxN);
+	}
+	if (argc > 1 && string(argv[1]) == "--pack") {
+		return runPack(argc > 2 ? argv[2] : ofToDataPath("assets.pack"));
+	}
+	if (argc > 3 && string(argv[1]) == "--replay" && string(argv[3]) == "--headless") {
+		return runReplay(argv[2]);
+	}
+
+	ofApp *app = new ofApp();
+	if (argc > 2 && string(argv[1]) == "--record") app->recordPath = argv[2];
+	if (argc > 2 && string(argv[1]) == "--replay") app->replayPath = argv[2];
+
 	ofSetupOpenGL(750, 1334,OF_WINDOW);			// <-------- setup the GL context
 
 	// this kicks off the running of my app
 	// can be OF_WINDOW or OF_FULLSCREEN
 	// pass in width and height too:
-	ofRunApp(new ofApp());
+	ofRunApp(app);
 
 }
@@ -3,176 +3,31 @@
 #include "ofMain.h"
 #include "ofxGui.h"
 #include <string> 
-#include "Particle.h"
-#include "ParticleEmitter.h"
+#include "GameWorld.h"
+#include "Simulation.h"
+#include "InputLog.h"
+#include "Profiler.h"
+#include "Telemetry.h"
+#include "AllocTracker.h"
+#include "Arena.h"
+#include "AssetLoader.h"
+#include "AudioManager.h"
+#include "Scene.h"
+#include "RenderQueue.h"
 
 typedef enum { MoveStop, MoveLeft, MoveRight, MoveUp, MoveDown } MoveDir;
 
-//  Shape base class
-//
-class Shape {
-public:
-	Shape() {}
-	virtual void draw() {}
-	virtual bool inside() { return false; }
-
-	glm::vec3 pos;
-	float rotation = 0.0;
-	glm::vec3 scale = glm::vec3(1.0, 1.0, 1.0);
-
-	vector<glm::vec3> verts;
-};
-
-//  TriangleShape
-//
-class TriangleShape : public Shape {
-public:
-	
-	TriangleShape(glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
-		verts.push_back(p1);
-		verts.push_back(p2);
-		verts.push_back(p3);
-	}
-	bool inside(glm::vec3 p, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3);
-	void draw();
-	ofImage spriteImage;
-	// Get heading vector for the ship 
-	//
-	glm::vec3 heading() {
-		
-		return glm::normalize(glm::vec3(cos(glm::radians(rotation + 270)) * 10, 
-			sin(glm::radians(rotation + 270)) * 10,0));
-
-
-	}
-
-	// Physics data goes here  (for integrate() );
-	//
-	ofVec3f thrust;
-	ofVec3f accel;
-	float damping;
-	float mass;
-	ofVec3f force;
-
-	//  Integrator Function 
-	//
-	void integrate() {
-		
-		
-		ofVec3f velocity = thrust * heading();
-		//cout << velocity << endl;
-		//cout << heading() << endl;
-		// (1) update position from velocity and time interval
-		// (2) update velocity (based on acceleration
-		// (3) multiply final result by the damping factor to sim drag
-		//
-	
-		float fr = ofGetFrameRate();
-		float dt = 1.0 / fr;
-		//cout << velocity << endl;
-		pos += velocity ;
-		velocity += accel * dt;
-		velocity = velocity * damping;
-	}
-};
-
-// This is a base object that all drawable object inherit from
-// It is possible this will be replaced by ofNode when we move to 3D
-//
-class BaseObject {
-public:
-	BaseObject();
-	ofVec2f trans, scale;
-	float	rot;
-	bool	bSelected;
-	void setPosition(ofVec3f);
-};
-
-//  General Sprite class  (similar to a Particle)
-//
-class Sprite : public BaseObject {
-public:
-	Sprite();
-	void draw();
-	void update();
-	float age();
-	void setImage(ofImage);
-	float speed;    //   in pixels/sec
-	ofVec3f velocity; // in pixels/sec
-	ofImage image;
-	float birthtime; // elapsed time in ms
-	float lifespan;  //  time in ms
-	string name;
-	bool haveImage;	
-	float width, height;  
-	ofVec3f heading;
-	glm::vec3 pos;
-	float cycles;
-	float scale;
-	 
-};
-
-//  Manages all Sprites in a system.  You can create multiple systems
-//
-class SpriteSystem {
-public:
-	void add(Sprite);
-	void remove(int);
-	void update();
-	void draw();
-	vector<Sprite> sprites;
-	int removeNear(ofVec3f point, float dist);
-	//glm::vec3 curveEval(float x, float scale, float cycles);
-	ofSoundPlayer explosionSound;
-	ParticleEmitter emitter;
-};
-
-//  General purpose Emitter class for emitting sprites
-//  This works similar to a Particle emitter
-//
-class Emitter : public BaseObject {
-public:
-	//TriangleShape triangleRef;
-	Emitter(SpriteSystem*);
-	virtual void move() {};
-	glm::vec3 heading;
-	void draw();
-	void start();
-	void stop();
-	void setLifespan(float);    // in milliseconds
-	void setVelocity(ofVec3f);  // pixel/sec
-	void setChildImage(ofImage);
-	void setChildSize(float w, float h) { childWidth = w; childHeight = h; }
-	void setImage(ofImage);
-	void setRate(float);
-	float maxDistPerFrame();
-	void update();
-	SpriteSystem* sys;
-	float rate;
-	ofVec3f velocity;
-	float lifespan;
-	bool started;
-	float lastSpawned;
-	ofImage childImage;
-	ofImage image;
-	bool drawable;
-	bool haveChildImage;
-	bool haveImage;
-	float width, height;
-	float childWidth, childHeight;
-	void launch();
-	void shoot();
-	ofSoundPlayer firingSound;
-};
-
-
 class ofApp : public ofBaseApp {
 
 public:
 	void setup();
 	void update();
 	void draw();
-	void checkCollisions();
+	void drawScene();
+	void drawLoading();
+	void drawRenderStats(float x, float y);
+	void startGame();
+	void exit();
 	void keyPressed(int key);
 	void keyReleased(int key);
 	void mouseMoved(int x, int y);
@@ -185,9 +40,55 @@ public:
 	void dragEvent(ofDragInfo dragInfo);
 	void gotMessage(ofMessage msg);
 
-	Emitter* invader, * invader2, * invader3, * invader4, * turret;
-	vector<Emitter*> invaders;
-	int numEmitters;
+	// the game simulation, stepped at a fixed rate on its own thread once
+	// setup() is done; draw() shows the latest snapshot of it
+	//
+	GameWorld world;
+	Simulation sim{ world };
+	const RenderSnapshot *snapshot = NULL;
+	float tickLength = 1.0 / 60;	// sec
+	int maxTicksPerFrame = 5;
+
+	void postInput(int type, int x = 0, int y = 0, float value = 0);
+	void postSettings();
+	bool settingsPosted = false;
+	float postedRate, postedLife, postedVelocity;
+
+	// memory for data that only lives for one frame (reset at the top of
+	// update())
+	//
+	Arena frameArena;
+
+	// input recording and replay (set from the command line before setup)
+	//
+	InputLog inputLog;
+	string recordPath;				// save the session's input here on exit
+	string replayPath;				// play back this session, ignoring live input
+
+	// frame profiler: 'p' shows the overlay, 't' saves a Chrome trace
+	//
+	Profiler profiler;
+	bool bProfile = false;
+
+	// per frame stats for external monitors (tools/telemetry_tail)
+	//
+	TelemetryRing telemetry;
+	void publishTelemetry();
+	unsigned long lastCreated = 0, lastExpired = 0, lastCollisions = 0;
+
+	// heap allocations per frame (only counted in LANDER_TRACK_ALLOCS
+	// builds), shown under the profiler overlay
+	//
+	AllocSnapshot allocFrameStart;
+	AllocSnapshot allocLastFrame;
+	void drawAllocOverlay(float x, float y);
+
+	// images, sounds and fonts, loaded in the background at startup; the
+	// game starts once loading is false
+	//
+	AssetLoader assets;
+	AssetPack pack;					// pre-decoded assets (lunarlander --pack), if any
+	bool loading = true;
 
 	ofImage spriteImage;
 	ofImage backgroundImage;
@@ -195,15 +96,21 @@ public:
 	ofImage invaderImage;
 
 
-	ofSoundPlayer firingSound;
-	ofSoundPlayer explosionSound;
+	// sound effects (ids in audio), mixed on the sound card's thread; the
+	// music streams from its MP3 through ofSoundPlayer.  The samples are
+	// declared first so the manager playing them goes before they do.
+	//
+	AudioSample firingSample;
+	AudioSample explosionSample;
+	AudioManager audio;
+	StreamAudioBackend audioOut;
+	int firingSound = -1;
+	int explosionSound = -1;
 	ofSoundPlayer musicSound;
 	
 	ofVec3f mouse_last;
 	bool imageLoaded;
-	bool bIdle;
 	bool bHide;
-	bool gOver;
 
 	ofxFloatSlider rate;
 	ofxFloatSlider thrust;
@@ -216,28 +123,17 @@ public:
 	ofxFloatSlider cycles;
 
 
-	glm::vec3 curveEval(float x, float scale, float cycles);
 	glm::vec3 heading;
 
 	// application data
 
 	glm::vec3 lastMouse;   // location of where mouse moved last (when dragging)
-	TriangleShape tri = TriangleShape(glm::vec3(-20, 20, 0), glm::vec3(0, -40, 0), glm::vec3(20, 20, 0));
-
-	bool draggable = false;		// indicates that the triangle can be dragged
-	glm::vec3 mouseLast;		// the last position of the mouse 
 
 	ofxPanel gui;
 	ofxToggle useImage;
 
-	int score = 0;
 	string scoreString;
 
-	//forces
-	TurbulenceForce* turbForce;
-	GravityForce* gravityForce;
-	ImpulseRadialForce* radialForce;
-
 	ofxVec3Slider turbMin;
 	ofxVec3Slider turbMax;
 	ofxFloatSlider mass;
@@ -251,12 +147,15 @@ public:
 	ofxFloatSlider particleLifespan;
 	ofxFloatSlider particleRate;
 
-	ParticleEmitter emitter;
-	
-
 	//font
 
 	ofTrueTypeFont	timerFont;
 	ofTrueTypeFont	gameShark30;
-	int timer;
+
+	// the frame's draw calls, recorded by the scene and sorted by layer and
+	// state before drawing
+	//
+	Scene scene;
+	RenderQueue renderQueue;
+	GLRenderBackend screen;
 };
@@ -0,0 +1,87 @@
+//  Tail the game's shared memory telemetry ring (see src/Telemetry.h).
+//
+//  Usage:  telemetry_tail [segment]       (default /lunarlander-telemetry)
+//
+//  Prints one CSV line per frame the game publishes.  Start it before or
+//  after the game; it waits for the segment to appear.  If the game is
+//  quit and started again it follows the new run.  If it falls more than a
+//  ring behind it skips ahead and reports how many frames it missed.
+//
+//  Build:  g++ -O2 -std=c++11 -I../src telemetry_tail.cpp ../src/Telemetry.cpp -o telemetry_tail
+//          (add -lrt on older Linux)
+//
+#include "Telemetry.h"
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+static void waitFor(TelemetryRing & ring, const string & name) {
+	while (!ring.open(name)) {
+		this_thread::sleep_for(chrono::milliseconds(500));
+	}
+}
+
+int main(int argc, char *argv[]) {
+	string name = argc > 1 ? argv[1] : "/lunarlander-telemetry";
+	const int pollMs = 50;
+	const int stallPolls = 1000 / pollMs;		// check for a new run after a second without frames
+
+	TelemetryRing ring;
+	waitFor(ring, name);
+
+	printf("frame,tick,frame_ms,fps,particles,sprites,collisions,spawned,expired,score\n");
+
+	uint64_t next = ring.written();
+	uint64_t capacity = ring.capacity();
+	int idlePolls = 0;
+	for (;;) {
+		uint64_t written = ring.written();
+		if (written < next) next = written;		// the game restarted the ring in place (Windows)
+
+		// the game closed its segment; a new run makes a new one under the
+		// same name, which we follow from its first frame
+		//
+		idlePolls = written == next ? idlePolls + 1 : 0;
+		if (idlePolls >= stallPolls) {
+			idlePolls = 0;
+			if (ring.replaced()) {
+				fprintf(stderr, "telemetry_tail: segment closed, waiting for the game\n");
+				ring.close();
+				waitFor(ring, name);
+				capacity = ring.capacity();
+				next = 0;
+				continue;
+			}
+		}
+		while (next < written) {
+			TelemetryRecord r;
+			if (!ring.read(next, r)) {
+				// overwritten before we got to it: skip to the oldest we can read
+				//
+				uint64_t oldest = ring.written() > capacity / 2 ? ring.written() - capacity / 2 : 0;
+				if (oldest > next) {
+					fprintf(stderr, "telemetry_tail: missed %llu frames\n", (unsigned long long)(oldest - next));
+					next = oldest;
+				}
+				continue;
+			}
+
+			// live counts per system, separated by '|'
+			//
+			string particles, sprites;
+			for (uint32_t i = 0; i < r.particleSystems && i < telemetryMaxSystems; i++)
+				particles += (i ? "|" : "") + to_string(r.liveParticles[i]);
+			for (uint32_t i = 0; i < r.spriteSystems && i < telemetryMaxSystems; i++)
+				sprites += (i ? "|" : "") + to_string(r.liveSprites[i]);
+
+			printf("%llu,%llu,%.3f,%.1f,%s,%s,%u,%u,%u,%d\n",
+				(unsigned long long)r.frame, (unsigned long long)r.tick, r.frameTime, r.fps,
+				particles.c_str(), sprites.c_str(), r.collisions, r.spawned, r.expired, r.score);
+			next++;
+		}
+		fflush(stdout);
+		this_thread::sleep_for(chrono::milliseconds(pollMs));
+	}
+}